@@ -7,229 +7,213 @@
 
 #include <AircraftRecord.h>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
-AircraftRecord::AircraftRecord(const std::string& ICAO_Address) : ICAO_Address(ICAO_Address)
+void AircraftRecord::Init(uint32_t icao, AircraftState* state, uint16_t slot, uint32_t timeMs)
 {
-	ticksToExpire = DEFAULT_LIVE_SPAN;
-	recordExpiered = false;
-	altitudeKnown = false;
-	flightNameKnown = false;
-	velocityAndHeadingKnown = false;
-
+	this->state = state;
+	this->slot = slot;
+	state->known[slot] = AircraftTracked;
+	state->stale[slot] = 0U;
+	state->lastSeenMs[slot] = timeMs;
+	state->flightNameTimeMs[slot] = timeMs;
+	state->altitudeTimeMs[slot] = timeMs;
+	state->velocityTimeMs[slot] = timeMs;
+	state->latitude[slot] = 0.0F;
+	state->longitude[slot] = 0.0F;
+	state->fixTimeMs[slot] = timeMs;
+	state->heading[slot] = 0.0F;
+	state->altitude[slot] = 0U;
+	state->velocity[slot] = 0U;
+	signalNext = 0U;
+	signalCount = 0U;
+	snprintf(icaoStr,sizeof(icaoStr),"%.6lX",(unsigned long)(icao & 0xFFFFFFU));
+	flightName[0] = '\0';
+	altStr[0] = '\0';
+	headStr[0] = '\0';
+	velocityStr[0] = '\0';
+	positionStr[0] = '\0';
+	positionStrTimeMs = 0U;
+	cpr.Reset();
 }
 
-void AircraftRecord::Tick(uint32_t ticks)
+void AircraftRecord::SetAltitude(const uint32_t& newAltitude, uint32_t timeMs)
 {
-	if(ticksToExpire > 0U)
-	{
-		if(ticksToExpire > ticks)
-		{
-			ticksToExpire -= ticks;
-		}
-		else
-		{
-			ticksToExpire = 0U;
-		}
-		if(ticksToExpire == 0U)
-		{
-			recordExpiered = true;
-		}
-
-	}
+	state->altitude[slot] = newAltitude;
+	state->altitudeTimeMs[slot] = timeMs;
+	state->known[slot] |= AircraftAltitude;
+	state->stale[slot] |= AircraftAltitude;
 }
 
-void AircraftRecord::SetAltitude(const uint32_t& newAltitude)
+void AircraftRecord::SetFlightName(const char* newFlightName, uint32_t timeMs)
 {
-	char buff[64];
-	sprintf(buff,"%lu ft",newAltitude);
-	altStr = std::string(buff);
-	altitude = newAltitude;
-	altitudeKnown = true;
-	ticksToExpire = DEFAULT_LIVE_SPAN;
+	strncpy(flightName,newFlightName,sizeof(flightName) - 1U);
+	flightName[sizeof(flightName) - 1U] = '\0';
+	state->flightNameTimeMs[slot] = timeMs;
+	state->known[slot] |= AircraftFlightName;
 }
 
-void AircraftRecord::SetFlightName(const char* newFlightName)
+void AircraftRecord::SetVelocityAndHeading(const int& velocity, const float& heading, uint32_t timeMs)
 {
-	flightName = std::string(newFlightName);
-	flightNameKnown = true;
-	ticksToExpire = DEFAULT_LIVE_SPAN;
+	state->velocityTimeMs[slot] = timeMs;
+	state->known[slot] |= AircraftVelocity;
+	state->stale[slot] |= AircraftVelocity;
+
+	state->velocity[slot] = (velocity < 0) ? 0U : (velocity > UINT16_MAX) ? UINT16_MAX : uint16_t(velocity);
+	state->heading[slot] = heading;
 }
 
-void AircraftRecord::SetVelocityAndHeading(const int& velocity, const float& heading)
+CprResult AircraftRecord::UpdatePosition(bool odd, int rawLat, int rawLon, uint32_t timeMs, const CprReceiver& receiver)
 {
-	char buff[64];
-	sprintf(buff,"%d kts",velocity);
-	velocityStr = std::string(buff);
-	float degHead = heading * 180.0F / M_PI;
-	if(degHead < 0.0F)
+	CprAngle lat;
+	CprAngle lon;
+	const CprResult result = cpr.Decode(odd, rawLat, rawLon, timeMs, receiver, lat, lon);
+	if(result == CprGlobalPosition || result == CprLocalPosition)
 	{
-		degHead += 360.0F;
+		state->latitude[slot] = CprAngleToDegrees(lat);
+		state->longitude[slot] = CprAngleToDegrees(lon);
+		state->fixTimeMs[slot] = timeMs;
+		state->known[slot] |= AircraftPosition;
+		state->stale[slot] |= AircraftPosition;
 	}
-	sprintf(buff,"%d",(int)degHead);
-	headStr = std::string(buff);
-	velocityAndHeadingKnown = true;
-	ticksToExpire = DEFAULT_LIVE_SPAN;
+	return result;
+}
 
-	this->velocity = velocity;
-	this->heading = heading;
+/* Degrees and the first four decimals in pairs of a coordinate's
+ * magnitude, shown as DDdd'dd". */
+static void FormatCoordinate(float degrees, uint8_t* parts)
+{
+	const float magnitude = std::fabs(degrees);
+	const uint32_t units = (magnitude < 180.0F) ? uint32_t(magnitude * 10000.0F + 0.5F) : 1800000U;
+	parts[0] = uint8_t(units / 10000U);
+	parts[1] = uint8_t(units / 100U % 100U);
+	parts[2] = uint8_t(units % 100U);
 }
-void AircraftRecord::decodeCPR(const int& fflag, const int& rawLat, const int& rawLon)
+
+bool AircraftRecord::TakeStale(uint8_t field) const
 {
-	float cprLat = float(rawLat)/131072.0F;
-	float cprLon = float(rawLon)/131072.0F;
+	if((state->stale[slot] & field) == 0U)
+	{
+		return false;
+	}
+	state->stale[slot] &= uint8_t(~field);
+	return true;
+}
 
-	double dLat;
-	if(fflag)
+const char* AircraftRecord::GetAltitudeStr() const
+{
+	if(TakeStale(AircraftAltitude))
 	{
-		dLat = 360.0F / 59.0F;
+		snprintf(altStr,sizeof(altStr),"%lu ft",(unsigned long)state->altitude[slot]);
 	}
-	else
+	return altStr;
+}
+
+/* Velocity and heading share a stale bit, both are formatted together. */
+const char* AircraftRecord::GetVelocityStr() const
+{
+	if(TakeStale(AircraftVelocity))
 	{
-		dLat = 360.0F / 60.0F;
+		snprintf(velocityStr,sizeof(velocityStr),"%u kts",(unsigned)state->velocity[slot]);
+		float degHead = state->heading[slot] * 180.0F / M_PI;
+		if(degHead < 0.0F)
+		{
+			degHead += 360.0F;
+		}
+		snprintf(headStr,sizeof(headStr),"%u",(unsigned)degHead % 360U);
 	}
-	uint32_t j = floor(latRef/dLat) + floor( CprMod(latRef,dLat)/dLat - cprLat + 0.5F );
+	return velocityStr;
+}
 
-	latitude = dLat * (float(j) + cprLat);
+const char* AircraftRecord::GetHeadingStr() const
+{
+	GetVelocityStr();
+	return headStr;
+}
 
-	float dLon;
-	float NlLat = cprNLFunction(latitude);
-	if( NlLat > 0)
+bool AircraftRecord::GetPosition(uint32_t timeMs, float& lat, float& lon) const
+{
+	if(!IsPositionKnown())
 	{
-		dLon = 360.0F/ NlLat;
+		return false;
 	}
-	else
+	lat = state->latitude[slot];
+	lon = state->longitude[slot];
+	const int32_t ageMs = int32_t(timeMs - state->fixTimeMs[slot]);
+	if(!IsVelocityAndHeadingKnown() || ageMs <= 0)
 	{
-		dLon = 360.0;
+		return true;
 	}
 
-	uint32_t m = floor(lonRef/dLon) + floor( CprMod(lonRef,dLon)/dLon - cprLon + 0.5F );
-	lognitude = dLon * (float(m) + cprLon);
-
-	char buff[256];
-	sprintf(buff,"%.4fN %.4fE",latitude,lognitude);
-	positionStr = std::string(buff);
-	positionStr.replace(2,1,"");
-	positionStr.insert(5,"'");
-	positionStr.insert(8,"\"");
-
-	positionStr.replace(13,1,"");
-	positionStr.insert(16,"'");
-	positionStr.insert(19,"\"");
-	ticksToExpire = DEFAULT_LIVE_SPAN;
-
+	/* Metres to degrees on a sphere of the mean earth radius. Over the
+	 * horizon the east-west scale stays the one at the fix. */
+	const float degreesPerMetre = 180.0F / (M_PI * 6371000.0F);
+	const uint32_t horizonMs = (uint32_t(ageMs) < POSITION_EXTRAPOLATION_MAX_MS) ? uint32_t(ageMs) : POSITION_EXTRAPOLATION_MAX_MS;
+	const float metres = state->velocity[slot] * (1852.0F / 3600.0F) * float(horizonMs) * 0.001F;
+	const float heading = state->heading[slot];
+	const float latCos = std::cos(lat * float(M_PI / 180.0));
+	lat += metres * std::cos(heading) * degreesPerMetre;
+	if(latCos > 0.01F)
+	{
+		lon += metres * std::sin(heading) * degreesPerMetre / latCos;
+		lon = (lon > 180.0F) ? lon - 360.0F : (lon < -180.0F) ? lon + 360.0F : lon;
+	}
+	return true;
 }
 
-
-void AircraftRecord::CalcNewPosition(int time)
+/* While a position is predicted the string is redone for every new time
+ * asked for. */
+const char* AircraftRecord::GetPositionStr(uint32_t timeMs) const
 {
-	if((velocityAndHeadingKnown == false) || ( altitudeKnown == false) )
-		return;
-    const float velInMs = velocity * 0.514444444;
-	const float dist = velInMs * (float)time;
-	const float earthR = 6371000.0F;
-
-	float distRatio = dist / earthR;
-	float distRatioSin = std::sin(distRatio);
-	float distRatioCos = std::cos(distRatio);
-
-	float startLatRad = latitude * M_PI/180.0F;
-	float startLonRad = lognitude * M_PI/180.0F;
-
-	float startLatCos = std::cos(startLatRad);
-	float startLatSin = std::sin(startLatRad);
-
-	float endLatRads = std::asin((startLatSin * distRatioCos) + (startLatCos * distRatioSin * std::cos(heading)));
-	float endLonRads = startLonRad + std::atan2(std::sin(heading) * distRatioSin * startLatCos,  distRatioCos - startLatSin * std::sin(endLatRads));
-
-	latitude = endLatRads * 180.0F / M_PI;
-	lognitude = endLonRads * 180.0F / M_PI;
-
-	char buff[256];
-	sprintf(buff,"%.4fN %.4fE",latitude,lognitude);
-	positionStr = std::string(buff);
-	positionStr.replace(2,1,"");
-	positionStr.insert(5,"'");
-	positionStr.insert(8,"\"");
-
-	positionStr.replace(13,1,"");
-	positionStr.insert(16,"'");
-	positionStr.insert(19,"\"");
-
-}
-float AircraftRecord::CprMod(const float& x, const float& y)
-{
-	return (x - y * floor(x/y));
+	const bool predicted = IsPositionKnown() && IsVelocityAndHeadingKnown();
+	if(TakeStale(AircraftPosition) || (predicted && timeMs != positionStrTimeMs))
+	{
+		float lat;
+		float lon;
+		GetPosition(timeMs, lat, lon);
+		positionStrTimeMs = timeMs;
+		uint8_t latParts[3];
+		uint8_t lonParts[3];
+		FormatCoordinate(lat, latParts);
+		FormatCoordinate(lon, lonParts);
+		snprintf(positionStr,sizeof(positionStr),"%u%02u'%02u\"%c %u%02u'%02u\"%c",
+				latParts[0],latParts[1],latParts[2],(lat < 0.0F) ? 'S' : 'N',
+				lonParts[0],lonParts[1],lonParts[2],(lon < 0.0F) ? 'W' : 'E');
+	}
+	return positionStr;
 }
 
-int AircraftRecord::cprNLFunction(double lat) {
-    if (lat < 0) lat = -lat; /* Table is simmetric about the equator. */
-    if (lat < 10.47047130) return 59;
-    if (lat < 14.82817437) return 58;
-    if (lat < 18.18626357) return 57;
-    if (lat < 21.02939493) return 56;
-    if (lat < 23.54504487) return 55;
-    if (lat < 25.82924707) return 54;
-    if (lat < 27.93898710) return 53;
-    if (lat < 29.91135686) return 52;
-    if (lat < 31.77209708) return 51;
-    if (lat < 33.53993436) return 50;
-    if (lat < 35.22899598) return 49;
-    if (lat < 36.85025108) return 48;
-    if (lat < 38.41241892) return 47;
-    if (lat < 39.92256684) return 46;
-    if (lat < 41.38651832) return 45;
-    if (lat < 42.80914012) return 44;
-    if (lat < 44.19454951) return 43;
-    if (lat < 45.54626723) return 42;
-    if (lat < 46.86733252) return 41;
-    if (lat < 48.16039128) return 40;
-    if (lat < 49.42776439) return 39;
-    if (lat < 50.67150166) return 38;
-    if (lat < 51.89342469) return 37;
-    if (lat < 53.09516153) return 36;
-    if (lat < 54.27817472) return 35;
-    if (lat < 55.44378444) return 34;
-    if (lat < 56.59318756) return 33;
-    if (lat < 57.72747354) return 32;
-    if (lat < 58.84763776) return 31;
-    if (lat < 59.95459277) return 30;
-    if (lat < 61.04917774) return 29;
-    if (lat < 62.13216659) return 28;
-    if (lat < 63.20427479) return 27;
-    if (lat < 64.26616523) return 26;
-    if (lat < 65.31845310) return 25;
-    if (lat < 66.36171008) return 24;
-    if (lat < 67.39646774) return 23;
-    if (lat < 68.42322022) return 22;
-    if (lat < 69.44242631) return 21;
-    if (lat < 70.45451075) return 20;
-    if (lat < 71.45986473) return 19;
-    if (lat < 72.45884545) return 18;
-    if (lat < 73.45177442) return 17;
-    if (lat < 74.43893416) return 16;
-    if (lat < 75.42056257) return 15;
-    if (lat < 76.39684391) return 14;
-    if (lat < 77.36789461) return 13;
-    if (lat < 78.33374083) return 12;
-    if (lat < 79.29428225) return 11;
-    if (lat < 80.24923213) return 10;
-    if (lat < 81.19801349) return 9;
-    if (lat < 82.13956981) return 8;
-    if (lat < 83.07199445) return 7;
-    if (lat < 83.99173563) return 6;
-    if (lat < 84.89166191) return 5;
-    if (lat < 85.75541621) return 4;
-    if (lat < 86.53536998) return 3;
-    if (lat < 87.00000000) return 2;
-    else return 1;
-}
 
-int AircraftRecord::cprNFunction(double lat, int isodd) {
-    int nl = cprNLFunction(lat) - isodd;
-    if (nl < 1) nl = 1;
-    return nl;
+void AircraftRecord::AddSignalLevel(uint16_t level)
+{
+	signalLevels[signalNext] = level;
+	signalNext = (signalNext + 1U) % RSSI_HISTORY;
+	if(signalCount < RSSI_HISTORY)
+	{
+		signalCount++;
+	}
 }
 
-double AircraftRecord::cprDlonFunction(double lat, int isodd) {
-    return 360.0 / cprNFunction(lat, isodd);
+RssiStats AircraftRecord::GetRssi() const
+{
+	RssiStats rssi = { -100.0F, -100.0F, -100.0F, signalCount };
+	if(signalCount == 0U)
+	{
+		return rssi;
+	}
+	uint16_t minLevel = signalLevels[0];
+	uint16_t maxLevel = signalLevels[0];
+	float power = 0.0F;
+	for(uint8_t i = 0U; i < signalCount; i++)
+	{
+		const uint16_t level = signalLevels[i];
+		minLevel = (level < minLevel) ? level : minLevel;
+		maxLevel = (level > maxLevel) ? level : maxLevel;
+		power += float(level) * float(level);
+	}
+	rssi.minDbfs = SignalLevelDbfs(minLevel);
+	rssi.avgDbfs = SignalLevelDbfs(std::sqrt(power / signalCount));
+	rssi.maxDbfs = SignalLevelDbfs(maxLevel);
+	return rssi;
 }
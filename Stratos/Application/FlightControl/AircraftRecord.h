@@ -8,68 +8,152 @@
 #ifndef FLIGHTCONTROL_AIRCRAFTRECORD_H_
 #define FLIGHTCONTROL_AIRCRAFTRECORD_H_
 
-#include "string"
 #include "ADSBMessage.h"
+#include "CprDecoder.h"
 
 #define homeLat 51.253811F
 #define homeLon 15.395468F
 #define dormLat 51.109402F
 #define dormLon 17.059798F
 
-#define DEFAULT_LIVE_SPAN 120U //120s
+#define DEFAULT_LIVE_SPAN 120U //120s without any message
+
+/* Default time a field stays known without an update, see AircraftTimeouts. */
+#define FLIGHT_NAME_TIMEOUT_MS 120000U
+#define ALTITUDE_TIMEOUT_MS 60000U
+#define VELOCITY_TIMEOUT_MS 60000U
+#define POSITION_TIMEOUT_MS 60000U
 #define latRef dormLat
 #define lonRef dormLon
 
-class AircraftRecord
-{
-public:
-	AircraftRecord() = default;
-	AircraftRecord(const std::string& ICAO_Address);
+#define RSSI_HISTORY 8U // frames
 
-	const std::string& GetICAO_Address() const {return ICAO_Address;}
-	const std::string& GetFlightName() const {return flightName;}
-	bool IsRecordExpiered() const {return recordExpiered;}
+#define POSITION_EXTRAPOLATION_MAX_MS 30000U	// predictions stop this long after the fix
 
-	void SetAltitude(const uint32_t& newAltitude);
-	void SetFlightName(const char* newFlightName);
-	void SetVelocityAndHeading(const int& velocity, const float& heading);
+#define MAX_AIRCRAFT 128U
 
-	const float& GetHeading() const {return heading;}
-	const float& GetLat() const { return latitude;}
-	const float& GetLon() const { return lognitude;}
-	uint32_t altitude;
+/* Signal strength over the last RSSI_HISTORY frames of an aircraft. */
+struct RssiStats
+{
+	float minDbfs;
+	float avgDbfs;	// of the mean power
+	float maxDbfs;
+	uint8_t frames;	// frames the figures are taken over, 0 if none yet
+};
 
-	std::string altStr;
-	std::string headStr;
-	std::string velocityStr;
-	std::string positionStr;
+/* What is known of an aircraft, bits of AircraftState::known. */
+enum AircraftField
+{
+	AircraftTracked = 0x01,		// the slot holds an aircraft
+	AircraftFlightName = 0x02,
+	AircraftAltitude = 0x04,
+	AircraftVelocity = 0x08,	// velocity and heading
+	AircraftPosition = 0x10
+};
 
-	bool flightNameKnown;
-	bool altitudeKnown;
-	bool velocityAndHeadingKnown;
-	void Tick(uint32_t ticks);
+/* Numeric state of all tracked aircraft, one array per field indexed by
+ * the aircraft's slot in the AircraftTable. Expiry works on these arrays
+ * only, without touching the records. Times are FreeRTOS tick times in ms
+ * of the messages, as the controller stamps them. */
+struct AircraftState
+{
+	float latitude[MAX_AIRCRAFT];		// last fix, as decoded
+	float longitude[MAX_AIRCRAFT];
+	uint32_t fixTimeMs[MAX_AIRCRAFT];
+	float heading[MAX_AIRCRAFT];		// radians
+	uint32_t altitude[MAX_AIRCRAFT];	// ft
+	uint16_t velocity[MAX_AIRCRAFT];	// kts
+	uint32_t lastSeenMs[MAX_AIRCRAFT];	// any message
+	uint32_t flightNameTimeMs[MAX_AIRCRAFT];
+	uint32_t altitudeTimeMs[MAX_AIRCRAFT];
+	uint32_t velocityTimeMs[MAX_AIRCRAFT];
+	uint8_t known[MAX_AIRCRAFT];		// AircraftField bits
+	uint8_t stale[MAX_AIRCRAFT];		// AircraftField bits whose display string is out of date
+};
 
-	void decodeCPR(const int& fflag, const int& cprLat, const int& cprLon);
+#define ICAO_STR_SIZE 7U
+#define FLIGHT_NAME_SIZE 9U
+#define ALTITUDE_STR_SIZE 14U	// "4294967295 ft"
+#define VELOCITY_STR_SIZE 10U	// "12345 kts"
+#define HEADING_STR_SIZE 5U		// "359"
+#define POSITION_STR_SIZE 32U	// "5110'94"N 1705'98"E"
+
+/* Rarely touched part of a tracked aircraft: identity, display strings,
+ * signal history and CPR frames, all in fixed size members so records can
+ * live in a static pool. The numbers behind the strings are kept in the
+ * AircraftState slot the record is bound to with Init().
+ *
+ * Updates only store the numbers and mark the field stale; its string is
+ * formatted when it is next asked for, i.e. when the view shows the row. */
+class AircraftRecord
+{
+public:
+	AircraftRecord() = default;
 
-	void CalcNewPosition(int time);
+	/* Binds the record to slot of state, for a newly tracked aircraft
+	 * first heard at timeMs. */
+	void Init(uint32_t icao, AircraftState* state, uint16_t slot, uint32_t timeMs);
+
+	uint16_t GetSlot() const {return slot;}
+	const char* GetICAO_Address() const {return icaoStr;}
+	const char* GetFlightName() const {return flightName;}
+	const char* GetAltitudeStr() const;
+	const char* GetHeadingStr() const;
+	const char* GetVelocityStr() const;
+	/* Of the position predicted for timeMs. */
+	const char* GetPositionStr(uint32_t timeMs) const;
+
+	bool IsFlightNameKnown() const {return (state->known[slot] & AircraftFlightName) != 0;}
+	bool IsAltitudeKnown() const {return (state->known[slot] & AircraftAltitude) != 0;}
+	bool IsVelocityAndHeadingKnown() const {return (state->known[slot] & AircraftVelocity) != 0;}
+	bool IsPositionKnown() const {return (state->known[slot] & AircraftPosition) != 0;}
+
+	/* Any message from the aircraft, keeps the record from expiring. */
+	void Seen(uint32_t timeMs) { state->lastSeenMs[slot] = timeMs;}
+	uint32_t GetLastSeenMs() const { return state->lastSeenMs[slot];}
+
+	void SetAltitude(const uint32_t& newAltitude, uint32_t timeMs);
+	void SetFlightName(const char* newFlightName, uint32_t timeMs);
+	void SetVelocityAndHeading(const int& velocity, const float& heading, uint32_t timeMs);
+
+	uint32_t GetAltitude() const {return state->altitude[slot];}
+	const float& GetHeading() const {return state->heading[slot];}
+	/* Last decoded fix and its time, never moved by predictions. */
+	const float& GetLat() const { return state->latitude[slot];}
+	const float& GetLon() const { return state->longitude[slot];}
+	uint32_t GetFixTimeMs() const { return state->fixTimeMs[slot];}
+
+	/* Feeds an airborne position frame stamped with its capture time. */
+	CprResult UpdatePosition(bool odd, int rawLat, int rawLon, uint32_t timeMs, const CprReceiver& receiver);
+
+	/* Position predicted for timeMs from the last fix, the velocity and the
+	 * heading, over a flat earth around the fix. The fix itself when the
+	 * velocity is unknown or timeMs is not after the fix; predictions go
+	 * at most POSITION_EXTRAPOLATION_MAX_MS ahead. False without a fix. */
+	bool GetPosition(uint32_t timeMs, float& lat, float& lon) const;
+
+	void AddSignalLevel(uint16_t level);
+	RssiStats GetRssi() const;
 private:
-	std::string ICAO_Address;
-
-	std::string flightName;
+	AircraftState* state;
+	uint16_t slot;
 
+	uint16_t signalLevels[RSSI_HISTORY];
+	uint8_t signalNext;
+	uint8_t signalCount;
 
+	char icaoStr[ICAO_STR_SIZE];
+	char flightName[FLIGHT_NAME_SIZE];
+	mutable char altStr[ALTITUDE_STR_SIZE];
+	mutable char headStr[HEADING_STR_SIZE];
+	mutable char velocityStr[VELOCITY_STR_SIZE];
+	mutable char positionStr[POSITION_STR_SIZE];
+	mutable uint32_t positionStrTimeMs;
 
-	uint32_t ticksToExpire;
-	bool recordExpiered;
+	CprDecoder cpr;
 
-	float latitude;
-	float lognitude;
-	float heading;
-	int velocity;
-	int cprNLFunction(double lat);
-	int cprNFunction(double lat, int isodd);
-	float CprMod(const float& x, const float& y);
-	double cprDlonFunction(double lat, int isodd);
+	/* Clears the stale bit of field, true if it was set. */
+	bool TakeStale(uint8_t field) const;
 };
 
 #endif /* FLIGHTCONTROL_AIRCRAFTRECORD_H_ */
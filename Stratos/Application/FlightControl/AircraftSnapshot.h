@@ -0,0 +1,42 @@
+/*
+ * AircraftSnapshot.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef FLIGHTCONTROL_AIRCRAFTSNAPSHOT_H_
+#define FLIGHTCONTROL_AIRCRAFTSNAPSHOT_H_
+
+#include <AircraftRecord.h>
+
+#include "TripleBuffer.h"
+
+/* What the view shows of one aircraft: the numbers for the radar and the
+ * list's strings, already formatted. */
+struct AircraftSnapshotEntry
+{
+	float latitude;		// predicted for the snapshot's time
+	float longitude;
+	float heading;		// radians
+	uint8_t known;		// AircraftField bits, AircraftPosition with latitude and longitude set
+	char icaoStr[ICAO_STR_SIZE];
+	char flightName[FLIGHT_NAME_SIZE];
+	char altitudeStr[ALTITUDE_STR_SIZE];
+	char positionStr[POSITION_STR_SIZE];
+	char velocityStr[VELOCITY_STR_SIZE];
+	char headingStr[HEADING_STR_SIZE];
+};
+
+/* The tracked aircraft as of timeMs. Built by the controller task,
+ * read by the GUI task, never changed while the GUI holds it. */
+struct AircraftSnapshot
+{
+	uint32_t version;	// counts the published snapshots
+	uint32_t timeMs;
+	uint16_t count;
+	AircraftSnapshotEntry aircraft[MAX_AIRCRAFT];
+};
+
+typedef TripleBuffer<AircraftSnapshot> AircraftSnapshots;
+
+#endif /* FLIGHTCONTROL_AIRCRAFTSNAPSHOT_H_ */
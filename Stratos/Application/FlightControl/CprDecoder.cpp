@@ -0,0 +1,290 @@
+/*
+ * CprDecoder.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "CprDecoder.h"
+
+/* All of the decoding is integer. Right shifts of negative numbers are
+ * arithmetic (floor) with gcc, which the zone index arithmetic relies on. */
+
+#define CPR_SCALE 131072					// 2^17, one zone
+#define CPR_HALF 65536						// half a zone, rounds the zone indices
+#define CPR_LAT_QUARTER (CPR_LAT_UNITS_PER_TURN / 4)
+
+/* Latitude transitions: NL(lat) < nl from cprNLThreshold[nl] CPR latitude
+ * units on, i.e. ceil(t * CPR_LAT_UNITS_PER_TURN / 360) of the transition
+ * latitudes t of the DO-260B NL table. Grid latitudes are whole units, so the
+ * comparison is exact. */
+static constexpr int32_t cprNLThreshold[60] = {
+	INT32_MAX, INT32_MAX,
+	112132096, 111533247, 110527984, 109414713, 108254821, 107069390, 105867611, 104654063,
+	103431203, 102200392, 100962375,  99717520,  98465957,  97207653,  95942457,  94670132,
+	 93390371,  92102810,  90807035,  89502585,  88188956,  86865600,  85531927,  84187300,
+	 82831033,  81462389,  80080576,  78684739,  77273956,  75847230,  74403479,  72941526,
+	 71460090,  69957765,  68433009,  66884121,  65309215,  63706194,  62072709,  60406118,
+	 58703430,  56961236,  55175617,  53342036,  51455186,  49508794,  47495356,  45405761,
+	 43228772,  40950252,  38551991,  36009853,  33290663,  30346612,  27104255,  23439815,
+	 19111659,  13495126
+};
+
+/* Transitions are at least 598849 units apart, so a bucket of 2^19 units
+ * holds at most one and NL is the bucket's NL, or one less. */
+#define CPR_NL_BUCKET_SHIFT 19
+#define CPR_NL_BUCKETS ((CPR_LAT_QUARTER >> CPR_NL_BUCKET_SHIFT) + 1)
+
+/* cos(latitude) in Q15 for the flat earth distances, buckets of 2^22 binary
+ * angle units (0.35 degrees) taken at their middle. */
+#define CPR_COS_BUCKET_SHIFT 22
+#define CPR_COS_BUCKETS ((1 << 30 >> CPR_COS_BUCKET_SHIFT) + 1)
+
+#define CPR_EARTH_CIRCUMFERENCE_M 40030173.6	// 2 pi 6371 km
+#define CPR_UNITS_PER_METRE_Q16 int64_t(4294967296.0 / CPR_EARTH_CIRCUMFERENCE_M * 65536.0 + 0.5)
+#define CPR_MAX_SPEED_MM_PER_MS (CPR_MAX_SPEED_KTS * 1852U / 3600U)
+
+/* 2^32 / 3540 in Q15 turns CPR latitude units into binary angle units. */
+#define CPR_LAT_UNITS_TO_ANGLE_Q32 int64_t(140737488355328.0 / 3540.0 + 0.5)
+
+/* Taylor series, exact to double precision up to a quarter turn. */
+static constexpr double CprCos(double x)
+{
+	double term = 1.0;
+	double sum = 1.0;
+	for(int i = 1; i < 12; i++)
+	{
+		term *= -x * x / ((2 * i - 1) * (2 * i));
+		sum += term;
+	}
+	return sum;
+}
+
+struct CprTables
+{
+	uint8_t nl[CPR_NL_BUCKETS];					// NL at the start of each bucket
+	int64_t zoneWidth[60];						// 2^32 / n, binary angle units
+	uint16_t cosQ15[CPR_COS_BUCKETS];
+
+	constexpr CprTables() : nl(), zoneWidth(), cosQ15()
+	{
+		int n = 59;
+		for(int b = 0; b < CPR_NL_BUCKETS; b++)
+		{
+			while(int32_t(b) << CPR_NL_BUCKET_SHIFT >= cprNLThreshold[n])
+			{
+				n--;
+			}
+			nl[b] = uint8_t(n);
+		}
+		for(int z = 1; z < 60; z++)
+		{
+			zoneWidth[z] = ((int64_t(1) << 32) + z / 2) / z;
+		}
+		for(int b = 0; b < CPR_COS_BUCKETS; b++)
+		{
+			const double angle = (b + 0.5) * (1 << CPR_COS_BUCKET_SHIFT) * (3.14159265358979323846 / 2147483648.0);
+			const double c = CprCos(angle < 3.14159265358979323846 / 2.0 ? angle : 3.14159265358979323846 / 2.0);
+			cosQ15[b] = uint16_t(c * 32768.0 + 0.5);
+		}
+	}
+};
+
+static constexpr CprTables cprTables;
+
+int CprNL(int32_t latUnits)
+{
+	const int32_t lat = (latUnits < 0) ? -latUnits : latUnits;
+	if(lat > CPR_LAT_QUARTER)
+	{
+		return 1;
+	}
+	int nl = cprTables.nl[lat >> CPR_NL_BUCKET_SHIFT];
+	if(lat >= cprNLThreshold[nl])
+	{
+		nl--;
+	}
+	return nl;
+}
+
+/* Number of longitude zones of an even or odd frame at lat. */
+static int CprN(int32_t latUnits, bool odd)
+{
+	const int n = CprNL(latUnits) - (odd ? 1 : 0);
+	return (n < 1) ? 1 : n;
+}
+
+static int32_t CprModInt(int32_t a, int32_t b)
+{
+	const int32_t res = a % b;
+	return (res < 0) ? res + b : res;
+}
+
+/* Position in CPR steps (zone * 2^17 + raw) of a zone width 1/n turn. */
+static CprAngle CprStepsToAngle(int64_t steps, int n)
+{
+	return CprAngle(uint32_t((steps * cprTables.zoneWidth[n]) >> 17));
+}
+
+static CprAngle CprLatToAngle(int32_t latUnits)
+{
+	return CprAngle((int64_t(latUnits) * CPR_LAT_UNITS_TO_ANGLE_Q32 + (int64_t(1) << 31)) >> 32);
+}
+
+bool CprGlobalDecode(int evenLat, int evenLon, int oddLat, int oddLon, bool oddNewer, CprAngle& lat, CprAngle& lon)
+{
+	/* Latitude zone index, floor((59 YZ0 - 60 YZ1) / 2^17 + 1/2). Even
+	 * zones are 59, odd ones 60 latitude units per CPR step. */
+	const int32_t j = (59 * evenLat - 60 * oddLat + CPR_HALF) >> 17;
+	int32_t latEven = 59 * (CprModInt(j, 60) * CPR_SCALE + evenLat);
+	int32_t latOdd = 60 * (CprModInt(j, 59) * CPR_SCALE + oddLat);
+	if(latEven >= 3 * CPR_LAT_QUARTER)
+	{
+		latEven -= CPR_LAT_UNITS_PER_TURN;
+	}
+	if(latOdd >= 3 * CPR_LAT_QUARTER)
+	{
+		latOdd -= CPR_LAT_UNITS_PER_TURN;
+	}
+	if(latEven < -CPR_LAT_QUARTER || latEven > CPR_LAT_QUARTER ||
+	   latOdd < -CPR_LAT_QUARTER || latOdd > CPR_LAT_QUARTER)
+	{
+		return false;
+	}
+
+	/* Both frames must come from the same longitude zone count. */
+	const int nl = CprNL(latEven);
+	if(nl != CprNL(latOdd))
+	{
+		return false;
+	}
+
+	const int32_t latUnits = oddNewer ? latOdd : latEven;
+	const int32_t m = (evenLon * (nl - 1) - oddLon * nl + CPR_HALF) >> 17;
+	const int n = CprN(latUnits, oddNewer);
+	lat = CprLatToAngle(latUnits);
+	lon = CprStepsToAngle(int64_t(CprModInt(m, n)) * CPR_SCALE + (oddNewer ? oddLon : evenLon), n);
+	return true;
+}
+
+bool CprLocalDecode(bool odd, int rawLat, int rawLon, CprAngle refLat, CprAngle refLon, CprAngle& lat, CprAngle& lon)
+{
+	/* Zone indices nearest to the reference, floor(ref / dlat - YZ / 2^17
+	 * + 1/2), in 2^-32 zones. */
+	const int nz = odd ? 59 : 60;
+	const int64_t j = (int64_t(refLat) * nz - (int64_t(rawLat) << 15) + (int64_t(1) << 31)) >> 32;
+	const int32_t latUnits = (odd ? 60 : 59) * (int32_t(j) * CPR_SCALE + rawLat);
+	if(latUnits < -CPR_LAT_QUARTER || latUnits > CPR_LAT_QUARTER)
+	{
+		return false;
+	}
+
+	const int n = CprN(latUnits, odd);
+	const int64_t m = (int64_t(refLon) * n - (int64_t(rawLon) << 15) + (int64_t(1) << 31)) >> 32;
+	lat = CprLatToAngle(latUnits);
+	lon = CprStepsToAngle(m * CPR_SCALE + rawLon, n);
+	return true;
+}
+
+bool CprWithin(CprAngle lat1, CprAngle lon1, CprAngle lat2, CprAngle lon2, uint32_t metres)
+{
+	const int64_t limit = (int64_t(metres) * CPR_UNITS_PER_METRE_Q16) >> 16;
+	if(limit >= INT32_MAX)
+	{
+		return true;
+	}
+	const uint32_t absLat = (lat1 < 0) ? 0U - uint32_t(lat1) : uint32_t(lat1);
+	const uint32_t bucket = absLat >> CPR_COS_BUCKET_SHIFT;
+	const int64_t cosLat = cprTables.cosQ15[bucket < CPR_COS_BUCKETS ? bucket : CPR_COS_BUCKETS - 1];
+
+	const int64_t dy = CprAngle(uint32_t(lat2) - uint32_t(lat1));
+	const int64_t dx = (CprAngle(uint32_t(lon2) - uint32_t(lon1)) * cosLat) >> 15;
+	if(dy > limit || dy < -limit || dx > limit || dx < -limit)
+	{
+		return false;
+	}
+	return dx * dx + dy * dy <= limit * limit;
+}
+
+
+CprDecoder::CprDecoder()
+{
+	Reset();
+}
+
+void CprDecoder::Reset()
+{
+	even.valid = false;
+	odd.valid = false;
+	fixValid = false;
+	fixLat = 0;
+	fixLon = 0;
+	fixTimeMs = 0U;
+}
+
+CprResult CprDecoder::Decode(bool isOdd, int rawLat, int rawLon, uint32_t timeMs, const CprReceiver& receiver,
+							 CprAngle& lat, CprAngle& lon)
+{
+	Frame& frame = isOdd ? odd : even;
+	const Frame& other = isOdd ? even : odd;
+	frame.rawLat = rawLat;
+	frame.rawLon = rawLon;
+	frame.timeMs = timeMs;
+	frame.valid = true;
+
+	CprAngle newLat;
+	CprAngle newLon;
+	CprResult result;
+	if(fixValid && (timeMs - fixTimeMs) <= CPR_LOCAL_MAX_AGE_MS)
+	{
+		if(!CprLocalDecode(isOdd, rawLat, rawLon, fixLat, fixLon, newLat, newLon))
+		{
+			Reset();
+			return CprRejected;
+		}
+		result = CprLocalPosition;
+	}
+	else
+	{
+		if(!other.valid || (timeMs - other.timeMs) > CPR_PAIR_MAX_AGE_MS)
+		{
+			return CprNoPosition;
+		}
+		/* A zone boundary crossed between the frames, wait for the next. */
+		if(!CprGlobalDecode(even.rawLat, even.rawLon, odd.rawLat, odd.rawLon, isOdd, newLat, newLon))
+		{
+			return CprNoPosition;
+		}
+		result = CprGlobalPosition;
+	}
+
+	if(!IsPlausible(newLat, newLon, timeMs, receiver))
+	{
+		Reset();
+		return CprRejected;
+	}
+	fixValid = true;
+	fixLat = newLat;
+	fixLon = newLon;
+	fixTimeMs = timeMs;
+	lat = newLat;
+	lon = newLon;
+	return result;
+}
+
+bool CprDecoder::IsPlausible(CprAngle lat, CprAngle lon, uint32_t timeMs, const CprReceiver& receiver) const
+{
+	if(receiver.maxRangeM > 0U &&
+	   !CprWithin(receiver.latitude, receiver.longitude, lat, lon, receiver.maxRangeM))
+	{
+		return false;
+	}
+	if(fixValid)
+	{
+		const uint64_t reach = uint64_t(timeMs - fixTimeMs) * CPR_MAX_SPEED_MM_PER_MS / 1000U + CPR_POSITION_MARGIN_M;
+		if(reach <= UINT32_MAX && !CprWithin(fixLat, fixLon, lat, lon, uint32_t(reach)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
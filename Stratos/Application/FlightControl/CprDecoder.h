@@ -0,0 +1,106 @@
+/*
+ * CprDecoder.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef FLIGHTCONTROL_CPRDECODER_H_
+#define FLIGHTCONTROL_CPRDECODER_H_
+
+#include <cstdint>
+
+#define CPR_PAIR_MAX_AGE_MS 10000U		// even and odd frame at most this far apart
+#define CPR_LOCAL_MAX_AGE_MS 120000U	// last fix usable as local reference
+#define CPR_MAX_SPEED_KTS 1000U		// fastest plausible ground speed
+#define CPR_POSITION_MARGIN_M 500U		// allowed on top of the distance flown
+#define CPR_DEFAULT_RANGE_KM 500.0F
+
+/* Binary angle, 2^32 units per turn: -180 to 180 degrees as int32_t with
+ * free wrap around, one unit is about 9 mm on the ground. */
+typedef int32_t CprAngle;
+
+#define CPR_UNITS_PER_DEGREE (4294967296.0 / 360.0)
+
+constexpr CprAngle CprAngleFromDegrees(double degrees)
+{
+	return CprAngle(uint32_t(int64_t(degrees * CPR_UNITS_PER_DEGREE + (degrees < 0.0 ? -0.5 : 0.5))));
+}
+
+inline float CprAngleToDegrees(CprAngle angle)
+{
+	return float(angle) * float(1.0 / CPR_UNITS_PER_DEGREE);
+}
+
+/* Latitudes decode first to CPR latitude units, 60 * 59 * 2^17 per turn,
+ * in which every even and odd grid latitude is a whole number. */
+#define CPR_LAT_UNITS_PER_TURN (60 * 59 * 131072)
+
+/* Where the receiver is and how far it can hear, for the range check. */
+struct CprReceiver
+{
+	CprAngle latitude;
+	CprAngle longitude;
+	uint32_t maxRangeM;	// 0 disables the range check
+};
+
+enum CprResult
+{
+	CprNoPosition = 0,	// frame stored, no pair and no reference yet
+	CprGlobalPosition,	// decoded from an even/odd pair
+	CprLocalPosition,	// decoded relative to the last fix
+	CprRejected			// out of range or implausibly fast, state reset
+};
+
+/* Airborne CPR (DO-260B 2.2.3.2.7.7) in integer arithmetic, 17 bit raw
+ * latitude and longitude. NL of a latitude in CPR latitude units. */
+int CprNL(int32_t latUnits);
+/* Global decode of an even/odd pair, the position of the newer frame.
+ * False when the two frames lie in different longitude zones. */
+bool CprGlobalDecode(int evenLat, int evenLon, int oddLat, int oddLon, bool oddNewer, CprAngle& lat, CprAngle& lon);
+/* Local decode of one frame, unambiguous within half a zone (about 300 km)
+ * of the reference. False when the latitude falls off the globe. */
+bool CprLocalDecode(bool odd, int rawLat, int rawLon, CprAngle refLat, CprAngle refLon, CprAngle& lat, CprAngle& lon);
+/* Whether two positions are at most the given distance apart, on a flat
+ * earth around the first one (good to about 1% at receiver ranges). */
+bool CprWithin(CprAngle lat1, CprAngle lon1, CprAngle lat2, CprAngle lon2, uint32_t metres);
+
+/* Position decoding state of one aircraft: the latest even and odd frame
+ * and the last accepted fix.
+ *
+ * Without a usable fix a position needs a fresh pair (CPR_PAIR_MAX_AGE_MS)
+ * and is decoded globally; after that every frame is decoded locally
+ * against the last fix, as long as it is not older than
+ * CPR_LOCAL_MAX_AGE_MS. Each fix must lie within range of the receiver and
+ * within CPR_MAX_SPEED_KTS of the previous fix; a failed check drops the
+ * stored frames and the fix, so the next pair starts over. */
+class CprDecoder
+{
+public:
+	CprDecoder();
+
+	CprResult Decode(bool odd, int rawLat, int rawLon, uint32_t timeMs, const CprReceiver& receiver,
+					 CprAngle& lat, CprAngle& lon);
+	bool HasFix() const { return fixValid; }
+	void Reset();
+
+private:
+	struct Frame
+	{
+		int rawLat;
+		int rawLon;
+		uint32_t timeMs;
+		bool valid;
+	};
+
+	bool IsPlausible(CprAngle lat, CprAngle lon, uint32_t timeMs, const CprReceiver& receiver) const;
+
+	Frame even;
+	Frame odd;
+
+	bool fixValid;
+	CprAngle fixLat;
+	CprAngle fixLon;
+	uint32_t fixTimeMs;
+};
+
+#endif /* FLIGHTCONTROL_CPRDECODER_H_ */
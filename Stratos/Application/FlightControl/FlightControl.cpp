@@ -7,54 +7,220 @@
 
 #include "FlightControl.h"
 
+#include <cstring>
+
 
 FlightControl::FlightControl()
 {
+	for(uint16_t slot = 0U; slot < MAX_AIRCRAFT; slot++)
+	{
+		state.known[slot] = 0U;
+		state.stale[slot] = 0U;
+		changed[slot] = 0U;
+	}
+	changedCount = 0U;
+	SetReceiver(latRef, lonRef, CPR_DEFAULT_RANGE_KM);
+	const AircraftTimeouts defaults = { FLIGHT_NAME_TIMEOUT_MS, ALTITUDE_TIMEOUT_MS, VELOCITY_TIMEOUT_MS,
+										POSITION_TIMEOUT_MS, DEFAULT_LIVE_SPAN * 1000U };
+	SetTimeouts(defaults);
+	rescheduleAll = false;
+}
+
+bool FlightControl::SetReceiver(float latitude, float longitude, float maxRangeKm)
+{
+	if(latitude < -90.0F || latitude > 90.0F || longitude < -180.0F || longitude > 180.0F || maxRangeKm < 0.0F || maxRangeKm > 20000.0F)
+	{
+		return false;
+	}
+	receiver.latitude = CprAngleFromDegrees(latitude);
+	receiver.longitude = CprAngleFromDegrees(longitude);
+	receiver.maxRangeM = uint32_t(maxRangeKm * 1000.0F);
+	return true;
 }
 
 
-bool FlightControl::FindAircraftByICAO_Address(const std::string& ICAO_Address, std::list<AircraftRecord>::iterator& retIt )
+AircraftRecord* FlightControl::FindAircraft(uint32_t icao)
 {
-	bool recordFound = false;
+	const AircraftTable::Handle handle = aircrafts.Find(icao);
+	if(handle == AircraftTable::InvalidHandle)
+	{
+		return NULL;
+	}
+	return &aircrafts.Get(handle);
+}
+
+/* The strings are copied whole, the record's buffers are the same size. */
+void FlightControl::TakeSnapshot(AircraftSnapshot& snapshot, uint32_t timeMs) const
+{
+	uint16_t count = 0U;
 	for(auto it = aircrafts.begin(); it != aircrafts.end(); it++)
 	{
-		if(it->GetICAO_Address() == ICAO_Address)
+		const AircraftRecord& record = *it;
+		AircraftSnapshotEntry& entry = snapshot.aircraft[count++];
+		entry.known = state.known[it.GetHandle()];
+		memcpy(entry.icaoStr, record.GetICAO_Address(), ICAO_STR_SIZE);
+		entry.flightName[0] = '\0';
+		entry.altitudeStr[0] = '\0';
+		entry.positionStr[0] = '\0';
+		entry.velocityStr[0] = '\0';
+		entry.headingStr[0] = '\0';
+		if(record.IsFlightNameKnown())
+		{
+			memcpy(entry.flightName, record.GetFlightName(), FLIGHT_NAME_SIZE);
+		}
+		if(record.IsAltitudeKnown())
 		{
-			retIt = it;
-			recordFound = true;
-			break;
+			memcpy(entry.altitudeStr, record.GetAltitudeStr(), ALTITUDE_STR_SIZE);
+		}
+		if(record.GetPosition(timeMs, entry.latitude, entry.longitude))
+		{
+			memcpy(entry.positionStr, record.GetPositionStr(timeMs), POSITION_STR_SIZE);
+		}
+		if(record.IsVelocityAndHeadingKnown())
+		{
+			entry.heading = record.GetHeading();
+			memcpy(entry.velocityStr, record.GetVelocityStr(), VELOCITY_STR_SIZE);
+			memcpy(entry.headingStr, record.GetHeadingStr(), HEADING_STR_SIZE);
 		}
 	}
+	snapshot.count = count;
+	snapshot.timeMs = timeMs;
+}
 
-	return recordFound;
+bool FlightControl::SetTimeouts(const AircraftTimeouts& newTimeouts)
+{
+	const uint32_t all[] = { newTimeouts.flightNameMs, newTimeouts.altitudeMs, newTimeouts.velocityMs,
+							 newTimeouts.positionMs, newTimeouts.recordMs };
+	uint32_t minMs = UINT32_MAX;
+	for(uint32_t timeoutMs : all)
+	{
+		if(timeoutMs == 0U || timeoutMs > INT32_MAX)
+		{
+			return false;
+		}
+		minMs = (timeoutMs < minMs) ? timeoutMs : minMs;
+	}
+	timeouts = newTimeouts;
+	minTimeoutMs = minMs;
+	/* Deadlines may have moved closer, ExpireRecords looks at all again. */
+	rescheduleAll = true;
+	return true;
 }
 
-void FlightControl::AddRecord(const AircraftRecord& record)
+AircraftRecord* FlightControl::AddRecord(uint32_t icao, uint32_t timeMs)
 {
-	aircrafts.push_back(record);
+	const AircraftTable::Handle handle = aircrafts.Insert(icao, AircraftRecord());
+	if(handle == AircraftTable::InvalidHandle)
+	{
+		return NULL;
+	}
+	AircraftRecord& record = aircrafts.Get(handle);
+	record.Init(icao, &state, handle, timeMs);
+	expiry.Schedule(handle, timeMs + minTimeoutMs);
+	Journal(handle, AircraftAdded, 0U);
+	return &record;
 }
 
-bool FlightControl::TickAllRecords(uint32_t ticks)
+void FlightControl::MarkChanged(const AircraftRecord& record, uint8_t fields)
 {
-	bool anyRecordExpiered = false;
-	auto it = aircrafts.begin();
-	while(it != aircrafts.end())
+	if(fields == 0U)
 	{
-		it->Tick(ticks);
-		bool recordExpired = it->IsRecordExpiered();
-		if(recordExpired == true)
-		{
-			anyRecordExpiered |= recordExpired;
-			auto it2 = it;
-			it++;
-			aircrafts.erase(it2);
-		}
-		else
+		return;
+	}
+	const uint16_t slot = record.GetSlot();
+	if(changed[slot] == 0U)
+	{
+		changedSlots[changedCount++] = slot;
+	}
+	changed[slot] |= fields;
+}
+
+/* Records are only erased by ExpireRecords(), after the flush, so every
+ * changed slot still holds the aircraft it was marked for. */
+void FlightControl::FlushChanges()
+{
+	for(uint16_t i = 0U; i < changedCount; i++)
+	{
+		const uint16_t slot = changedSlots[i];
+		Journal(slot, AircraftChanged, changed[slot]);
+		changed[slot] = 0U;
+	}
+	changedCount = 0U;
+}
+
+void FlightControl::Journal(uint16_t slot, AircraftChangeKind kind, uint8_t fields)
+{
+	const AircraftChange change = { aircrafts.GetKey(slot), slot, uint8_t(kind), fields };
+	journal.Append(change);
+}
+
+bool FlightControl::ExpireRecords(uint32_t timeMs)
+{
+	if(rescheduleAll)
+	{
+		expiry.Clear(timeMs);
+		for(auto it = aircrafts.begin(); it != aircrafts.end(); it++)
 		{
-			it->CalcNewPosition(ticks);
-			it++;
+			expiry.Schedule(it.GetHandle(), timeMs);
 		}
+		rescheduleAll = false;
+	}
+	FlushChanges();
+	bool anyExpired = false;
+	expiry.Advance(timeMs, [this, timeMs, &anyExpired](ExpiryWheel::Handle slot) {
+		anyExpired = CheckExpiry(slot, timeMs) || anyExpired;
+	});
+	return anyExpired;
+}
+
+/* Clears field from known once timeoutMs went by since fieldTimeMs,
+ * otherwise brings nextMs forward to its deadline. */
+static void ExpireField(uint8_t field, uint32_t fieldTimeMs, uint32_t timeoutMs, uint32_t timeMs,
+						uint8_t& known, uint32_t& nextMs)
+{
+	if((known & field) == 0U)
+	{
+		return;
+	}
+	const uint32_t deadlineMs = fieldTimeMs + timeoutMs;
+	if(int32_t(timeMs - deadlineMs) >= 0)
+	{
+		known &= uint8_t(~field);
+	}
+	else if(int32_t(deadlineMs - nextMs) < 0)
+	{
+		nextMs = deadlineMs;
 	}
+}
 
-	return anyRecordExpiered;
+bool FlightControl::CheckExpiry(uint16_t slot, uint32_t timeMs)
+{
+	if(int32_t(timeMs - state.lastSeenMs[slot]) >= int32_t(timeouts.recordMs))
+	{
+		Journal(slot, AircraftExpired, 0U);
+		state.known[slot] = 0U;
+		aircrafts.EraseHandle(slot);
+		return true;
+	}
+	/* A field that becomes known later times out minTimeoutMs after that
+	 * at the earliest, so looking again by then is soon enough. */
+	uint32_t nextMs = state.lastSeenMs[slot] + timeouts.recordMs;
+	if(int32_t(timeMs + minTimeoutMs - nextMs) < 0)
+	{
+		nextMs = timeMs + minTimeoutMs;
+	}
+	const uint8_t known = state.known[slot];
+	uint8_t stillKnown = known;
+	ExpireField(AircraftFlightName, state.flightNameTimeMs[slot], timeouts.flightNameMs, timeMs, stillKnown, nextMs);
+	ExpireField(AircraftAltitude, state.altitudeTimeMs[slot], timeouts.altitudeMs, timeMs, stillKnown, nextMs);
+	ExpireField(AircraftVelocity, state.velocityTimeMs[slot], timeouts.velocityMs, timeMs, stillKnown, nextMs);
+	ExpireField(AircraftPosition, state.fixTimeMs[slot], timeouts.positionMs, timeMs, stillKnown, nextMs);
+	state.known[slot] = stillKnown;
+	expiry.Schedule(slot, nextMs);
+	if(stillKnown == known)
+	{
+		return false;
+	}
+	Journal(slot, AircraftChanged, uint8_t(known & ~stillKnown));
+	return true;
 }
@@ -9,25 +9,111 @@
 #define FLIGHTCONTROL_FLIGHTCONTROL_H_
 
 #include <AircraftRecord.h>
-#include <string>
-#include <list>
+#include <AircraftSnapshot.h>
 
 #include "ADSBMessage.h"
+#include "ChangeJournal.h"
+#include "IcaoTable.h"
+#include "TimingWheel.h"
+
+#define EXPIRY_WHEEL_SLOTS 256U
+#define EXPIRY_WHEEL_SLOT_MS 1000U
+
+#define AIRCRAFT_JOURNAL_SIZE 512U		// entries, a few ticks of a full table
+#define AIRCRAFT_JOURNAL_CONSUMERS 4U
+
+typedef IcaoTable<AircraftRecord, MAX_AIRCRAFT> AircraftTable;
+typedef TimingWheel<MAX_AIRCRAFT, EXPIRY_WHEEL_SLOTS, EXPIRY_WHEEL_SLOT_MS> ExpiryWheel;
+
+enum AircraftChangeKind
+{
+	AircraftAdded = 0,
+	AircraftChanged,	// fields updated or timed out
+	AircraftExpired
+};
+
+/* Entry of the model's change journal. Consumers read the aircraft's
+ * present state from the model, so an entry only says where to look. */
+struct AircraftChange
+{
+	uint32_t icao;
+	uint16_t slot;		// of the AircraftTable and AircraftState
+	uint8_t kind;		// AircraftChangeKind
+	uint8_t fields;		// AircraftField bits, of AircraftChanged
+};
+
+typedef ChangeJournal<AircraftChange, AIRCRAFT_JOURNAL_SIZE, AIRCRAFT_JOURNAL_CONSUMERS> AircraftJournal;
+
+/* How long each field stays known without an update, and a record stays
+ * tracked without any message, in ms. A field that times out is cleared
+ * from AircraftState::known and no longer shown. */
+struct AircraftTimeouts
+{
+	uint32_t flightNameMs;
+	uint32_t altitudeMs;
+	uint32_t velocityMs;	// and heading
+	uint32_t positionMs;
+	uint32_t recordMs;
+};
 
 class FlightControl
 {
 public:
 	FlightControl();
 
-	bool FindAircraftByICAO_Address(const std::string& ICAO_Address,std::list<AircraftRecord>::iterator& retIt);
-	void AddRecord(const AircraftRecord& record);
+	/* Record of the aircraft, NULL if it is not tracked. */
+	AircraftRecord* FindAircraft(uint32_t icao);
+	/* Starts tracking an aircraft first heard at timeMs, NULL when
+	 * MAX_AIRCRAFT are tracked. The record stays at its address until it
+	 * expires. */
+	AircraftRecord* AddRecord(uint32_t icao, uint32_t timeMs);
+
+	/* Drops the fields and records that timed out by timeMs, true if any
+	 * did. Only the aircraft whose next deadline came up are looked at.
+	 * Flushes the pending changes first. */
+	bool ExpireRecords(uint32_t timeMs);
+
+	/* Fields of record updated by a message. They are collected per
+	 * aircraft and journaled as one AircraftChanged by FlushChanges(). */
+	void MarkChanged(const AircraftRecord& record, uint8_t fields);
+	void FlushChanges();
+	/* Added, changed and expired aircraft, in order, for consumers that
+	 * keep their own state instead of rescanning all records. */
+	AircraftJournal& GetJournal() { return journal;}
+	/* FLIGHT_NAME_TIMEOUT_MS etc. and DEFAULT_LIVE_SPAN until set. */
+	bool SetTimeouts(const AircraftTimeouts& newTimeouts);
+	const AircraftTimeouts& GetTimeouts() const { return timeouts;}
+
+	const AircraftTable& GetAllRecords() const { return aircrafts;}
+	const AircraftState& GetState() const { return state;}
+	/* Fills snapshot with every tracked aircraft as shown at timeMs, all
+	 * but its version. */
+	void TakeSnapshot(AircraftSnapshot& snapshot, uint32_t timeMs) const;
 
-	bool TickAllRecords(uint32_t ticks);
-	const std::list<AircraftRecord>& GetAllRecords() const { return aircrafts;}
+	/* Receiver position and range for the position checks, latRef/lonRef
+	 * and CPR_DEFAULT_RANGE_KM until set. */
+	bool SetReceiver(float latitude, float longitude, float maxRangeKm);
+	const CprReceiver& GetReceiver() const { return receiver;}
 private:
-	std::list<AircraftRecord> aircrafts;
+	/* Both are sized for MAX_AIRCRAFT at build time, the model allocates
+	 * nothing once constructed. */
+	AircraftTable aircrafts;
+	AircraftState state;
+	CprReceiver receiver;
 
+	/* Every tracked aircraft is in the wheel once, at its next deadline
+	 * or earlier. */
+	bool CheckExpiry(uint16_t slot, uint32_t timeMs);
+	ExpiryWheel expiry;
+	AircraftTimeouts timeouts;
+	uint32_t minTimeoutMs;
+	bool rescheduleAll;
 
+	void Journal(uint16_t slot, AircraftChangeKind kind, uint8_t fields);
+	AircraftJournal journal;
+	uint8_t changed[MAX_AIRCRAFT];			// AircraftField bits not journaled yet
+	uint16_t changedSlots[MAX_AIRCRAFT];	// slots with changed bits, in order of the first
+	uint16_t changedCount;
 };
 
 #endif /* FLIGHTCONTROL_FLIGHTCONTROL_H_ */
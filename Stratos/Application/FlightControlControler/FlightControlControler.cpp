@@ -6,9 +6,9 @@
  */
 
 #include "FlightControlControler.h"
-#include "stm32f7xx_hal.h"
 
-FlightControlControler::FlightControlControler(FlightControl& model,FlightCotrolView& view) : model(model), view(view)
+FlightControlControler::FlightControlControler(FlightControl& model,FlightCotrolView& view,const SampleClock& sampleClock) :
+		model(model), view(view), sampleClock(sampleClock)
 {
 	modelChanged = false;
 }
@@ -25,73 +25,83 @@ void FlightControlControler::NotifyConnected()
 
 void FlightControlControler::PassNewMessage(const ADS_BMessage& msg)
 {
-	std::string ICAO_Address = GetICAO_AddresAsString(msg);
-	bool recordExist = false;
-	std::list<AircraftRecord>::iterator recordIt;
-
-	if(!msg.crcok)
+	if(!msg.CrcOk())
 	{
 		//view.UpdateStats(msg);
 		return;
 	}
-	recordExist = model.FindAircraftByICAO_Address(ICAO_Address,recordIt);
+	const uint32_t icao = msg.Icao();
+	const uint32_t timeMs = TimeMs(msg.Timestamp());
+	AircraftRecord* record = model.FindAircraft(icao);
 
-	if(recordExist == false)
+	if(record == NULL)
 	{
-		AircraftRecord newRecord = AircraftRecord(ICAO_Address);
-		UpdateRecord(msg,newRecord);
-		model.AddRecord(newRecord);
-
-	}
-	else
-	{
-		UpdateRecord(msg,*recordIt);
+		record = model.AddRecord(icao, timeMs);
+		if(record == NULL)
+		{
+			return;
+		}
 	}
+	model.MarkChanged(*record,UpdateRecord(msg,*record,timeMs));
 	//view.UpdateStats(msg);
 	modelChanged = true;
 }
 
-void FlightControlControler::UpdateRecord(const ADS_BMessage& msg, AircraftRecord& record)
+uint8_t FlightControlControler::UpdateRecord(const ADS_BMessage& msg, AircraftRecord& record, uint32_t timeMs)
 {
+	 uint8_t fields = 0U;
+	 record.Seen(timeMs);
+	 record.AddSignalLevel(msg.signalLevel);
 	 switch(msg.msgtype)
 	 {
 	 case DF17:
 
-		 if (msg.metype >= 1 && msg.metype <= 4)
+		 if (msg.IsIdentification())
 		 {
-			 record.SetFlightName(msg.flight);
+			 char flight[9];
+			 msg.Flight(flight);
+			 record.SetFlightName(flight,timeMs);
+			 fields = AircraftFlightName;
 		 }
-		 else if(msg.metype >= 9 && msg.metype <= 18)
+		 else if(msg.IsAirbornePosition())
 		 {
-			 record.SetAltitude(msg.altitude);
-			 record.decodeCPR(msg.fflag,msg.raw_latitude,msg.raw_longitude);
+			 int unit;
+			 record.SetAltitude(msg.Altitude(&unit),timeMs);
+			 const CprResult fix = record.UpdatePosition(msg.CprOdd(),msg.RawLatitude(),msg.RawLongitude(),timeMs,model.GetReceiver());
+			 fields = AircraftAltitude;
+			 if(fix == CprGlobalPosition || fix == CprLocalPosition)
+			 {
+				 fields |= AircraftPosition;
+			 }
 
 		 }
-		 else if(msg.metype == 19 && msg.mesub >= 1 && msg.mesub <= 4)
+		 else if(msg.IsAirborneVelocity())
 		 {
-			 record.SetVelocityAndHeading(msg.velocity,msg.heading);
+			 record.SetVelocityAndHeading(msg.Velocity(),msg.Heading(),timeMs);
+			 fields = AircraftVelocity;
 		 }
 		 break;
 	 }
+	 return fields;
 }
 
-std::string FlightControlControler::GetICAO_AddresAsString(const ADS_BMessage& msg)
-{
-	char buff[9];
-	std::sprintf(buff,"%.2X%.2X%.2X",msg.aa1,msg.aa2,msg.aa3);
-	return std::string(buff);
-}
-
-void FlightControlControler::UpdateTicksCount(uint32_t ticks)
+void FlightControlControler::ExpireRecords()
 {
-	if(model.TickAllRecords(ticks) == true)
+	if(model.ExpireRecords(TimeMs(sampleClock.Now())) == true)
 	{
 		modelChanged = true;
 	}
 }
 
+uint32_t FlightControlControler::TimeMs(uint64_t timestamp) const
+{
+	return sampleClock.ToTick(timestamp) * portTICK_PERIOD_MS;
+}
+
 void FlightControlControler::UpdateView()
 {
-		view.Update(model.GetAllRecords());
+		model.FlushChanges();
+		model.TakeSnapshot(view.NextSnapshot(),TimeMs(sampleClock.Now()));
+		view.Publish();
 		modelChanged = false;
 }
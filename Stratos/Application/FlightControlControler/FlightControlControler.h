@@ -11,6 +11,7 @@
 #include "FlightCotrolView.h"
 #include "ADSBMessage.h"
 #include "FlightControl.h"
+#include "SampleClock.h"
 
 enum ModeSMessage
 {
@@ -22,22 +23,30 @@ enum ModeSMessage
 class FlightControlControler
 {
 public:
-	FlightControlControler(FlightControl& model,FlightCotrolView& view);
+	FlightControlControler(FlightControl& model,FlightCotrolView& view,const SampleClock& sampleClock);
 
 	void PassNewMessage(const ADS_BMessage& msg);
-	std::string GetICAO_AddresAsString(const ADS_BMessage& msg);
 
-	void UpdateRecord(const ADS_BMessage& msg, AircraftRecord& record);
+	/* AircraftField bits the message updated. */
+	uint8_t UpdateRecord(const ADS_BMessage& msg, AircraftRecord& record, uint32_t timeMs);
 
-	void UpdateTicksCount(uint32_t ticks);
+	/* Expires what timed out by the sample clock's present time. */
+	void ExpireRecords();
+	/* Publishes the model as of now to the view, for the GUI task, with
+	 * all changes journaled. */
 	void UpdateView();
 
 	void NotifyDisconnected();
 	void NotifyConnected();
 private:
 
+	/* FreeRTOS tick time in ms of a sample clock timestamp, the time base
+	 * of fixes and predictions. */
+	uint32_t TimeMs(uint64_t timestamp) const;
+
 	FlightControl& model;
 	FlightCotrolView& view;
+	const SampleClock& sampleClock;
 
 	bool modelChanged;
 
@@ -65,7 +65,7 @@ WM_HWIN aircraftsLitView;
 WM_HWIN radarImage;
 WM_HWIN radar;
 WM_HWIN statisticListView;
-std::list<AircraftRecord>* pAircrafts = NULL;
+const AircraftSnapshot* pSnapshot = NULL;	// GUI task only
 //extern const U8 _acImage_0[76390];
 
 /*
@@ -111,15 +111,21 @@ float calcBear(const float& lat1,const float lon1, const float& lat2,const float
 	return hdg;
 }
 
-void DisplayAircraft(const AircraftRecord& record)
+void DisplayAircraft(const AircraftSnapshotEntry& aircraft)
 {
 
 	const float NmPerPixel = COVERAGE*2.0F/520.0;
-	float dNm  = calcDistance(latRef, lonRef, record.GetLat(), record.GetLon()) * 0.000539956803F;
+	if((aircraft.known & AircraftPosition) == 0U)
+	{
+		return;
+	}
+	const float lat = aircraft.latitude;
+	const float lon = aircraft.longitude;
+	float dNm  = calcDistance(latRef, lonRef, lat, lon) * 0.000539956803F;
 
 	int y = dNm/NmPerPixel;
 	int x = 0;
-	float deg = calcBear(record.GetLat(), record.GetLon(), latRef, lonRef);
+	float deg = calcBear(lat, lon, latRef, lonRef);
 
 	float xEnd = (x*std::cos(deg) - y*std::sin(deg)) + xCenter;
 	float yEnd = (y*std::cos(deg) + x*std::sin(deg)) + yCenter;
@@ -130,13 +136,13 @@ void DisplayAircraft(const AircraftRecord& record)
 
 	float x1 = 0.0;
 	float y1 = -10.0;
-	deg =  record.GetHeading();
+	deg =  aircraft.heading;
 	float x2 = x1*std::cos(deg) - y1*std::sin(deg);
 	float y2 = y1*std::cos(deg) + x1*std::sin(deg);
 	GUI_SetPenSize(2);
 	GUI_DrawLine(xEnd,yEnd,xEnd + x2,yEnd+y2);
 
-	GUI_DispStringAt(record.GetICAO_Address().c_str(), xEnd, yEnd - 12 );
+	GUI_DispStringAt(aircraft.icaoStr, xEnd, yEnd - 12 );
 
 }
 
@@ -176,13 +182,14 @@ void cbImage(WM_MESSAGE * pMsg)
 			sprintf(b,"%d",i);
 			GUI_DispStringAt(b, x1 + xCenter - 9,y1 + yCenter -4);
 		}
-		if(pAircrafts != NULL)
+		if(pSnapshot != NULL)
 			{
-				for(auto it = pAircrafts->begin(); it != pAircrafts->end(); it++)
+				for(uint16_t i = 0; i < pSnapshot->count; i++)
 				{
-					if((it->altitudeKnown == true) && (it->velocityAndHeadingKnown == true))
+					const AircraftSnapshotEntry& aircraft = pSnapshot->aircraft[i];
+					if((aircraft.known & (AircraftAltitude | AircraftVelocity)) == (AircraftAltitude | AircraftVelocity))
 					{
-						DisplayAircraft(*it);
+						DisplayAircraft(aircraft);
 					}
 				}
 			}
@@ -512,6 +519,7 @@ WM_HWIN CreateWindow(void) {
 FlightCotrolView::FlightCotrolView()
 {
 	rows = 0;
+	published = 0U;
 
 }
 
@@ -535,7 +543,7 @@ void FlightCotrolView::UpdateStats(const ADS_BMessage& msg)
 	 static uint32_t bad_crc = 0;
 
 	 std::string a("test");
-	 if(!msg.crcok)
+	 if(!msg.CrcOk())
 	 {
 		 return;
 	 }
@@ -544,14 +552,14 @@ void FlightCotrolView::UpdateStats(const ADS_BMessage& msg)
 	 case 17:
 		 sprintf(buffstat,"%lu",++adsb_rec);
 		 LISTVIEW_SetItemText(statisticListView,0,0,buffstat);
-		 if (msg.metype >= 1 && msg.metype <= 4)
+		 if (msg.IsIdentification())
 		 {
 			 sprintf(buffstat,"%lu",++id_rec);
 			 LISTVIEW_SetItemText(statisticListView,4,0,buffstat);
 		 }
-		 else if(msg.metype >= 9 && msg.metype <= 18)
+		 else if(msg.IsAirbornePosition())
 		 {
-			 if(msg.fflag == 0)
+			 if(msg.CprOdd() == 0)
 			 {
 				 sprintf(buffstat,"%lu",++pos_odd);
 				 LISTVIEW_SetItemText(statisticListView,3,0,buffstat);
@@ -562,7 +570,7 @@ void FlightCotrolView::UpdateStats(const ADS_BMessage& msg)
 				 LISTVIEW_SetItemText(statisticListView,2,0,buffstat);
 			 }
 		 }
-		 else if(msg.metype == 19 && msg.mesub >= 1 && msg.mesub <= 4)
+		 else if(msg.IsAirborneVelocity())
 		 {
 			 sprintf(buffstat,"%lu",++vel_rec);
 			 LISTVIEW_SetItemText(statisticListView,1,0,buffstat);
@@ -571,41 +579,50 @@ void FlightCotrolView::UpdateStats(const ADS_BMessage& msg)
 	 }
 }
 */
-void FlightCotrolView::Update(const std::list<AircraftRecord>& aircrafts)
+void FlightCotrolView::Publish()
+{
+	snapshots.Back().version = ++published;
+	snapshots.Publish();
+}
+
+void FlightCotrolView::Refresh()
 {
+	if(snapshots.Acquire() == false)
+	{
+		return;
+	}
+	const AircraftSnapshot& snapshot = snapshots.Front();
 	LISTVIEW_DeleteAllRows(aircraftsLitView);
-	uint16_t cur_row = 0;
-	for(auto it = aircrafts.begin(); it != aircrafts.end(); it++)
+	for(uint16_t cur_row = 0; cur_row < snapshot.count; cur_row++)
 	{
-		const AircraftRecord& currentRecord = *it;
-		GUI_ConstString ICAO_AsCString = currentRecord.GetICAO_Address().c_str();
+		const AircraftSnapshotEntry& aircraft = snapshot.aircraft[cur_row];
+		GUI_ConstString ICAO_AsCString = aircraft.icaoStr;
 		LISTVIEW_AddRow(aircraftsLitView,&ICAO_AsCString);
 		for(uint8_t i = 1; i < 5; i++)
 		{
 			LISTVIEW_SetItemText(aircraftsLitView,i,cur_row,"");
 		}
 
-		if(currentRecord.altitudeKnown == true)
+		if((aircraft.known & AircraftAltitude) != 0U)
 		{
-			LISTVIEW_SetItemText(aircraftsLitView,1,cur_row,currentRecord.altStr.c_str());
-			LISTVIEW_SetItemText(aircraftsLitView,2,cur_row,currentRecord.positionStr.c_str());
+			LISTVIEW_SetItemText(aircraftsLitView,1,cur_row,aircraft.altitudeStr);
+			LISTVIEW_SetItemText(aircraftsLitView,2,cur_row,aircraft.positionStr);
 		}
 
-		if(currentRecord.velocityAndHeadingKnown == true)
+		if((aircraft.known & AircraftVelocity) != 0U)
 		{
-			LISTVIEW_SetItemText(aircraftsLitView,3,cur_row,currentRecord.velocityStr.c_str());
-			LISTVIEW_SetItemText(aircraftsLitView,4,cur_row,currentRecord.headStr.c_str());
+			LISTVIEW_SetItemText(aircraftsLitView,3,cur_row,aircraft.velocityStr);
+			LISTVIEW_SetItemText(aircraftsLitView,4,cur_row,aircraft.headingStr);
 
 		}
-		if(currentRecord.flightNameKnown == true)
+		if((aircraft.known & AircraftFlightName) != 0U)
 		{
-			LISTVIEW_SetItemText(aircraftsLitView,5,cur_row,currentRecord.GetFlightName().c_str());
+			LISTVIEW_SetItemText(aircraftsLitView,5,cur_row,aircraft.flightName);
 		}
-		cur_row++;
 	}
 
-	pAircrafts = &(const_cast<std::list<AircraftRecord>&>(aircrafts));
-
+	pSnapshot = &snapshot;
+	UpdateRadar();
 }
 
 void FlightCotrolView::UpdateRadar()
@@ -10,7 +10,7 @@
 
 #include <AircraftRecord.h>
 #include <string>
-#include <list>
+#include "FlightControl.h"
 #include "DIALOG.h"
 
 class FlightCotrolView
@@ -18,7 +18,14 @@ class FlightCotrolView
 public:
 	FlightCotrolView();
 	void ShowNewAircraft(const AircraftRecord& aircraft);
-	void Update(const std::list<AircraftRecord>& aircrafts);
+
+	/* Controller task: the snapshot to fill, then Publish() hands it to
+	 * the GUI. */
+	AircraftSnapshot& NextSnapshot() { return snapshots.Back();}
+	void Publish();
+	/* GUI task: shows the latest published snapshot, if there is a new
+	 * one. The radar draws the same one until the next refresh. */
+	void Refresh();
 	void Init();
 	void UpdateRadar();
 	void UpdateStats(const ADS_BMessage& msg);
@@ -28,6 +35,8 @@ public:
 	void HideWarningMsg();
 private:
 	int rows;
+	AircraftSnapshots snapshots;
+	uint32_t published;
 
 };
 
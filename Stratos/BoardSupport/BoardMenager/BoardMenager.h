@@ -17,7 +17,6 @@
 #include "RTLSDR.h"
 
 #define ADS_B_FREQUENCY 1090000000U
-#define ADS_B_SAMPLING  2000000U
 class BoardMenager
 {
 public:
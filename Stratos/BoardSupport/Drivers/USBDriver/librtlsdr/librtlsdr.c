@@ -366,8 +366,13 @@ static rtlsdr_dongle_t known_devices[] = {
     { 0x1f4d, 0xd803, "PROlectrix DV107669" },
 };
 
-#define DEFAULT_BUF_NUMBER	15
-#define DEFAULT_BUF_LENGTH	(16 * 32 * 512)
+/* upstream uses 15 x 256 KiB, sized down to fit the MCU heap */
+#define DEFAULT_BUF_NUMBER	4
+#define DEFAULT_BUF_LENGTH	(16 * 512)
+
+/* the port finishes a cancelled transfer at once, this only bounds the
+   wind down if a transfer never comes back */
+#define MAX_CANCEL_ROUNDS	3
 
 #define DEF_RTL_XTAL_FREQ	28800000
 #define MIN_RTL_XTAL_FREQ	(DEF_RTL_XTAL_FREQ - 1000)
@@ -1485,6 +1490,10 @@ int rtlsdr_read_sync(rtlsdr_dev_t* dev, volatile void* buf, int len, int* n_read
     if (!dev)
     { return -1; }
 
+    /* both paths use the same IN pipe */
+    if (RTLSDR_INACTIVE != dev->async_status)
+    { return -2; }
+
     return libusb_bulk_transfer(dev->devh, 0x81, buf, len, n_read, BULK_TIMEOUT);
 }
 
@@ -1495,8 +1504,22 @@ static void LIBUSB_CALL _libusb_callback(struct libusb_transfer* xfer) {
         if (dev->cb)
         { dev->cb(xfer->buffer, xfer->actual_length, dev->cb_ctx); }
 
-        libusb_submit_transfer(xfer); /* resubmit transfer */
+        dev->xfer_errors = 0;
+
+        /* the callback may have cancelled the stream */
+        if (RTLSDR_RUNNING == dev->async_status)
+        { libusb_submit_transfer(xfer); /* resubmit transfer */ }
+
+    } else if (LIBUSB_TRANSFER_CANCELLED != xfer->status) {
+        dev->xfer_errors++;
 
+        if (dev->xfer_errors >= dev->xfer_buf_num ||
+                LIBUSB_TRANSFER_NO_DEVICE == xfer->status) {
+            dev->dev_lost = 1;
+            rtlsdr_cancel_async(dev);
+        } else if (RTLSDR_RUNNING == dev->async_status) {
+            libusb_submit_transfer(xfer);
+        }
     }
 }
 
@@ -1511,19 +1534,33 @@ static int _rtlsdr_alloc_async_buffers(rtlsdr_dev_t* dev) {
     { return -1; }
 
     if (!dev->xfer) {
-        dev->xfer = malloc(dev->xfer_buf_num *
+        dev->xfer = calloc(dev->xfer_buf_num,
                            sizeof(struct libusb_transfer*));
 
-        for (i = 0; i < dev->xfer_buf_num; ++i)
-        { dev->xfer[i] = libusb_alloc_transfer(0); }
+        if (!dev->xfer)
+        { return -1; }
+
+        for (i = 0; i < dev->xfer_buf_num; ++i) {
+            dev->xfer[i] = libusb_alloc_transfer(0);
+
+            if (!dev->xfer[i])
+            { return -1; }
+        }
     }
 
     if (!dev->xfer_buf) {
-        dev->xfer_buf = malloc(dev->xfer_buf_num *
+        dev->xfer_buf = calloc(dev->xfer_buf_num,
                                sizeof(unsigned char*));
 
-        for (i = 0; i < dev->xfer_buf_num; ++i)
-        { dev->xfer_buf[i] = malloc(dev->xfer_buf_len); }
+        if (!dev->xfer_buf)
+        { return -1; }
+
+        for (i = 0; i < dev->xfer_buf_num; ++i) {
+            dev->xfer_buf[i] = malloc(dev->xfer_buf_len);
+
+            if (!dev->xfer_buf[i])
+            { return -1; }
+        }
     }
 
     return 0;
@@ -1561,13 +1598,12 @@ static int _rtlsdr_free_async_buffers(rtlsdr_dev_t* dev) {
 
 int rtlsdr_read_async(rtlsdr_dev_t* dev, rtlsdr_read_async_cb_t cb, void* ctx,
                       uint32_t buf_num, uint32_t buf_len) {
-    return 0;
-
     unsigned int i;
     int r = 0;
     struct timeval tv = { 1, 0 };
     struct timeval zerotv = { 0, 0 };
     enum rtlsdr_async_status next_status = RTLSDR_INACTIVE;
+    unsigned int cancel_rounds = 0;
 
     if (!dev)
     { return -1; }
@@ -1593,7 +1629,13 @@ int rtlsdr_read_async(rtlsdr_dev_t* dev, rtlsdr_read_async_cb_t cb, void* ctx,
     else
     { dev->xfer_buf_len = DEFAULT_BUF_LENGTH; }
 
-    _rtlsdr_alloc_async_buffers(dev);
+    dev->xfer_errors = 0;
+
+    if (_rtlsdr_alloc_async_buffers(dev) < 0) {
+        _rtlsdr_free_async_buffers(dev);
+        dev->async_status = RTLSDR_INACTIVE;
+        return -ENOMEM;
+    }
 
     for (i = 0; i < dev->xfer_buf_num; ++i) {
         libusb_fill_bulk_transfer(dev->xfer[i],
@@ -1651,7 +1693,8 @@ int rtlsdr_read_async(rtlsdr_dev_t* dev, rtlsdr_read_async_cb_t cb, void* ctx,
                 }
             }
 
-            if (dev->dev_lost || RTLSDR_INACTIVE == next_status) {
+            if (dev->dev_lost || RTLSDR_INACTIVE == next_status ||
+                    ++cancel_rounds >= MAX_CANCEL_ROUNDS) {
                 /*  handle any events that still need to
                     be handled before exiting after we
                     just cancelled all transfers */
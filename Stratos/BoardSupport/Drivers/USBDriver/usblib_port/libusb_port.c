@@ -3,16 +3,230 @@
 #include "usbh_pipes.h"
 #include "usb_host.h"
 #include "main.h"
+#include "libusb_port.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdlib.h>
+#include <sys/time.h>
 
 uint8_t usb_device_ready;
 uint8_t OutPipe;
 uint8_t InPipe = 2;
 extern USBH_HandleTypeDef hUsbHostHS;
 
-struct libusb_transfer* LIBUSB_CALL libusb_alloc_transfer(int iso_packets) { return 0; }
-int LIBUSB_CALL libusb_submit_transfer(struct libusb_transfer* transfer) { return 0; }
-int LIBUSB_CALL libusb_cancel_transfer(struct libusb_transfer* transfer) { return 0; }
-void LIBUSB_CALL libusb_free_transfer(struct libusb_transfer* transfer) { }
+/*
+    Asynchronous bulk IN transfers.
+
+    The host channel of the IN pipe runs one URB at a time, so submitted
+    transfers wait in a FIFO and the URB completion interrupt starts the next
+    one before it reports the finished one: with two or more transfers
+    submitted the dongle is never left without a request. Finished transfers
+    go to a second FIFO that libusb_handle_events_timeout() drains in the
+    calling task, where their callbacks run.
+
+    Both FIFOs hold pointers and are indexed by free running counters. The
+    task side works inside a critical section, the interrupt needs none.
+
+    Cancelling the active transfer halts the channel, so the HCD stops
+    writing to its buffer before the owner gets it back. The channel then
+    stays closed, and whatever it still reports is ignored, until the next
+    transfer reopens it.
+*/
+static struct libusb_transfer* submitted[LIBUSB_PORT_MAX_TRANSFERS];
+static volatile uint32_t submittedHead;
+static volatile uint32_t submittedTail;
+static struct libusb_transfer* volatile activeTransfer;
+static volatile int inPipeHalted;
+
+static struct libusb_transfer* finished[LIBUSB_PORT_MAX_TRANSFERS];
+static volatile uint32_t finishedHead;
+static volatile uint32_t finishedTail;
+static SemaphoreHandle_t finishedSignal;
+
+#define FIFO_INDEX(n) ((n) & (LIBUSB_PORT_MAX_TRANSFERS - 1))
+
+#define IN_PIPE_MPS 512
+
+/* Opens the IN channel again after a cancel halted it. Reinitialising it
+   drops the halt and any interrupt still pending; the toggle starts from
+   DATA0 like the endpoint after rtlsdr_reset_buffer. Called with the
+   interrupt masked. */
+static void reopen_in_pipe(uint8_t endpoint) {
+    if (!inPipeHalted)
+    { return; }
+
+    USBH_OpenPipe(&hUsbHostHS,
+                  InPipe,
+                  endpoint,
+                  hUsbHostHS.device.address,
+                  hUsbHostHS.device.speed,
+                  USB_EP_TYPE_BULK,
+                  IN_PIPE_MPS);
+    USBH_LL_SetToggle(&hUsbHostHS, InPipe, 0);
+    inPipeHalted = 0;
+}
+
+/* Starts the oldest submitted transfer if the channel is idle. Called with
+   the interrupt masked or from the interrupt itself. */
+static void start_next_transfer(void) {
+    struct libusb_transfer* transfer;
+
+    if (activeTransfer || submittedHead == submittedTail)
+    { return; }
+
+    transfer = submitted[FIFO_INDEX(submittedTail)];
+    submittedTail++;
+    activeTransfer = transfer;
+
+    USBH_BulkReceiveData(&hUsbHostHS,
+                         transfer->buffer,
+                         transfer->length,
+                         InPipe);
+}
+
+/* Every transfer in use is in exactly one place: submitted, active,
+   finished or with its owner, so the finished FIFO cannot overflow. */
+static void finish_transfer(struct libusb_transfer* transfer,
+                            enum libusb_transfer_status status) {
+    transfer->status = status;
+    finished[FIFO_INDEX(finishedHead)] = transfer;
+    finishedHead++;
+}
+
+int libusb_port_urb_callback(uint8_t chnum, int urb_state) {
+    struct libusb_transfer* transfer = activeTransfer;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (chnum != InPipe)
+    { return 0; }
+
+    /* Left over from the URB a cancel halted. */
+    if (inPipeHalted)
+    { return 1; }
+
+    if (!transfer)
+    { return 0; }
+
+    if (USBH_URB_DONE == urb_state) {
+        transfer->actual_length = USBH_LL_GetLastXferSize(&hUsbHostHS, InPipe);
+        finish_transfer(transfer, LIBUSB_TRANSFER_COMPLETED);
+    } else if (USBH_URB_STALL == urb_state) {
+        finish_transfer(transfer, LIBUSB_TRANSFER_STALL);
+    } else if (USBH_URB_ERROR == urb_state) {
+        finish_transfer(transfer, LIBUSB_TRANSFER_ERROR);
+    } else {
+        /* NAK and NYET, the HAL retries the URB itself. */
+        return 1;
+    }
+
+    activeTransfer = NULL;
+    start_next_transfer();
+
+    xSemaphoreGiveFromISR(finishedSignal, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    return 1;
+}
+
+/* No critical section: the caller either is the IN channel's interrupt or
+   has no URB outstanding on it, and the async stream is checked for. */
+int libusb_port_submit_in(uint8_t endpoint, unsigned char* data, int length) {
+    if (activeTransfer || submittedHead != submittedTail)
+    { return LIBUSB_ERROR_BUSY; }
+
+    reopen_in_pipe(endpoint);
+    USBH_BulkReceiveData(&hUsbHostHS, data, length, InPipe);
+    return 0;
+}
+
+struct libusb_transfer* LIBUSB_CALL libusb_alloc_transfer(int iso_packets) {
+    if (!finishedSignal)
+    { finishedSignal = xSemaphoreCreateBinary(); }
+
+    return calloc(1, sizeof(struct libusb_transfer) +
+                  iso_packets * sizeof(struct libusb_iso_packet_descriptor));
+}
+
+int LIBUSB_CALL libusb_submit_transfer(struct libusb_transfer* transfer) {
+    int r = 0;
+
+    if (!transfer || !finishedSignal)
+    { return LIBUSB_ERROR_INVALID_PARAM; }
+
+    if (LIBUSB_TRANSFER_TYPE_BULK != transfer->type ||
+            !(transfer->endpoint & LIBUSB_ENDPOINT_IN))
+    { return LIBUSB_ERROR_NOT_SUPPORTED; }
+
+    taskENTER_CRITICAL();
+
+    if (submittedHead - submittedTail == LIBUSB_PORT_MAX_TRANSFERS) {
+        r = LIBUSB_ERROR_NO_MEM;
+    } else {
+        transfer->actual_length = 0;
+        submitted[FIFO_INDEX(submittedHead)] = transfer;
+        submittedHead++;
+        reopen_in_pipe(transfer->endpoint);
+        start_next_transfer();
+    }
+
+    taskEXIT_CRITICAL();
+    return r;
+}
+
+/* A transfer still waiting in the FIFO is taken out and finished as
+   cancelled straight away. A running URB is halted first, so either way the
+   transfer is finished as cancelled before this returns and the buffer is
+   the owner's again once its callback ran. */
+int LIBUSB_CALL libusb_cancel_transfer(struct libusb_transfer* transfer) {
+    uint32_t i;
+    int r = LIBUSB_ERROR_NOT_FOUND;
+    int halted = 0;
+
+    taskENTER_CRITICAL();
+
+    if (transfer == activeTransfer) {
+        USBH_ClosePipe(&hUsbHostHS, InPipe);
+        inPipeHalted = 1;
+        activeTransfer = NULL;
+        finish_transfer(transfer, LIBUSB_TRANSFER_CANCELLED);
+        halted = 1;
+        r = 0;
+    }
+
+    for (i = submittedTail; i != submittedHead; i++) {
+        if (submitted[FIFO_INDEX(i)] != transfer)
+        { continue; }
+
+        for (; i + 1 != submittedHead; i++)
+        { submitted[FIFO_INDEX(i)] = submitted[FIFO_INDEX(i + 1)]; }
+
+        submittedHead--;
+        finish_transfer(transfer, LIBUSB_TRANSFER_CANCELLED);
+        r = 0;
+        break;
+    }
+
+    /* Whatever was queued behind a cancelled active transfer is cancelled
+       with it, the stream ends there. */
+    if (halted) {
+        while (submittedTail != submittedHead) {
+            finish_transfer(submitted[FIFO_INDEX(submittedTail)],
+                            LIBUSB_TRANSFER_CANCELLED);
+            submittedTail++;
+        }
+    }
+
+    taskEXIT_CRITICAL();
+
+    if (0 == r)
+    { xSemaphoreGive(finishedSignal); }
+
+    return r;
+}
+
+void LIBUSB_CALL libusb_free_transfer(struct libusb_transfer* transfer) {
+    free(transfer);
+}
 int LIBUSB_CALL libusb_init(libusb_context** ctx) { return 0; }
 void LIBUSB_CALL libusb_exit(libusb_context* ctx) {  }
 void LIBUSB_CALL libusb_set_debug(libusb_context* ctx, int level) {  }
@@ -80,6 +294,19 @@ int libusb_control_transfer(libusb_device_handle* dev_handle,
 int libusb_bulk_transfer(libusb_device_handle* dev_handle,
                          unsigned char endpoint, unsigned char* data, int length,
                          int* actual_length, unsigned int timeout) {
+    UBaseType_t mask;
+
+    /* Also called from the URB completion interrupt, where the task level
+       critical section asserts and would drop BASEPRI on exit. */
+    if (xPortIsInsideInterrupt()) {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        reopen_in_pipe(endpoint);
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    } else {
+        taskENTER_CRITICAL();
+        reopen_in_pipe(endpoint);
+        taskEXIT_CRITICAL();
+    }
 
     USBH_BulkReceiveData(&hUsbHostHS,
                          data, // rx buffer
@@ -126,7 +353,34 @@ void LIBUSB_CALL libusb_lock_events(libusb_context* ctx) { }
 
 void LIBUSB_CALL libusb_unlock_events(libusb_context* ctx) { }
 
-int LIBUSB_CALL libusb_handle_events_timeout(libusb_context* ctx, void* tv) { return 0; }
+/* Waits up to tv for a transfer to finish, then runs the callbacks of all
+   finished transfers in the calling task. */
+int LIBUSB_CALL libusb_handle_events_timeout(libusb_context* ctx, void* tv) {
+    struct timeval* timeout = (struct timeval*)tv;
+    struct libusb_transfer* transfer;
+    TickType_t ticks = 0;
+
+    if (!finishedSignal)
+    { return LIBUSB_ERROR_NOT_FOUND; }
+
+    if (timeout)
+    { ticks = pdMS_TO_TICKS(timeout->tv_sec * 1000 + timeout->tv_usec / 1000); }
+
+    if (finishedHead == finishedTail)
+    { xSemaphoreTake(finishedSignal, ticks); }
+
+    while (finishedHead != finishedTail) {
+        taskENTER_CRITICAL();
+        transfer = finished[FIFO_INDEX(finishedTail)];
+        finishedTail++;
+        taskEXIT_CRITICAL();
+
+        if (transfer->callback)
+        { transfer->callback(transfer); }
+    }
+
+    return 0;
+}
 
 int LIBUSB_CALL libusb_event_handling_ok(libusb_context* ctx) { return 0; }
 
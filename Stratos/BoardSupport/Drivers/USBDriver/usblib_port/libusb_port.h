@@ -0,0 +1,32 @@
+#ifndef LIBUSB_PORT_H_
+#define LIBUSB_PORT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Transfers that can be submitted at once, a power of two. */
+#ifndef LIBUSB_PORT_MAX_TRANSFERS
+#define LIBUSB_PORT_MAX_TRANSFERS 16
+#endif
+
+/* To be called from HAL_HCD_HC_NotifyURBChange_Callback. Finishes the
+   asynchronous transfer running on the channel and starts the next one
+   submitted. Returns 0 when no asynchronous transfer owns the channel and
+   it was not halted by a cancel, the URB then belongs to the synchronous
+   libusb_bulk_transfer path. */
+int libusb_port_urb_callback(uint8_t chnum, int urb_state);
+
+/* Starts one bulk IN URB into data on the IN pipe, reopening it if a cancel
+   halted it. Makes no FreeRTOS calls, so it may run in the URB completion
+   interrupt, where the RTLSDR sample ring resubmits. Fails while an
+   asynchronous stream owns the channel. */
+int libusb_port_submit_in(uint8_t endpoint, unsigned char* data, int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUSB_PORT_H_ */
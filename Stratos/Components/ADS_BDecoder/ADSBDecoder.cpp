@@ -6,69 +6,159 @@
  */
 
 #include "ADSBDecoder.h"
-#include <cmath>
 #include <cstring>
-#include "FlightControlControler.h"
-
-extern FlightControlControler controler;
-
-static uint32_t modes_checksum_table[112] = {
-0x3935ea, 0x1c9af5, 0xf1b77e, 0x78dbbf, 0xc397db, 0x9e31e9, 0xb0e2f0, 0x587178,
-0x2c38bc, 0x161c5e, 0x0b0e2f, 0xfa7d13, 0x82c48d, 0xbe9842, 0x5f4c21, 0xd05c14,
-0x682e0a, 0x341705, 0xe5f186, 0x72f8c3, 0xc68665, 0x9cb936, 0x4e5c9b, 0xd8d449,
-0x939020, 0x49c810, 0x24e408, 0x127204, 0x093902, 0x049c81, 0xfdb444, 0x7eda22,
-0x3f6d11, 0xe04c8c, 0x702646, 0x381323, 0xe3f395, 0x8e03ce, 0x4701e7, 0xdc7af7,
-0x91c77f, 0xb719bb, 0xa476d9, 0xadc168, 0x56e0b4, 0x2b705a, 0x15b82d, 0xf52612,
-0x7a9309, 0xc2b380, 0x6159c0, 0x30ace0, 0x185670, 0x0c2b38, 0x06159c, 0x030ace,
-0x018567, 0xff38b7, 0x80665f, 0xbfc92b, 0xa01e91, 0xaff54c, 0x57faa6, 0x2bfd53,
-0xea04ad, 0x8af852, 0x457c29, 0xdd4410, 0x6ea208, 0x375104, 0x1ba882, 0x0dd441,
-0xf91024, 0x7c8812, 0x3e4409, 0xe0d800, 0x706c00, 0x383600, 0x1c1b00, 0x0e0d80,
-0x0706c0, 0x038360, 0x01c1b0, 0x00e0d8, 0x00706c, 0x003836, 0x001c1b, 0xfff409,
-0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,
-0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,
-0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000
-};
-
-ADS_BDecoder::ADS_BDecoder(QueueHandle_t messageQueue) : messageQueue(messageQueue)
+#include <cstdlib>
+#include "CycleCounter.h"
+
+static_assert(ADS_B_SAMPLING == MODES_SAMPLING_2000K || ADS_B_SAMPLING == MODES_SAMPLING_2400K,
+              "ADS_B_SAMPLING must be 2000000 or 2400000");
+
+ADS_BDecoder::ADS_BDecoder(MessageBus& messageBus, SampleClock& sampleClock) :
+    messageBus(messageBus), sampleClock(sampleClock)
 {
-    for (uint8_t i = 0; i <= 128; i++) {
-        for (uint8_t q = 0; q <= 128; q++) {
-            maglut[i*129+q] = round(sqrt(i*i+q*q)*360);
-        }
-    }
+    magnitudeKernel = GetDefaultMagnitudeKernel();
+    demodTable = &demodTable2000;
+    demodulator = ClassicDemodulator;
+    SetSampleRate(ADS_B_SAMPLING);
+    crcCorrection = CrcCorrectionSingleBit;
+    SetCrcEngine(CrcTableEngine);
+    preambleFilter = true;
+    streamingMode = true;
+    bufferStart = 0;
+    clockEpoch = 0;
+    ResetStream();
+    ResetStats();
+}
 
+bool ADS_BDecoder::SetMagnitudeKernel(MagnitudeKernelType type)
+{
+	const MagnitudeKernel* kernel = ::GetMagnitudeKernel(type);
+	if (kernel == NULL) {
+		return false;
+	}
+	magnitudeKernel = kernel;
+	return true;
 }
 
-void ADS_BDecoder::ProcessRawSamples(uint8_t* rawSamples)
+bool ADS_BDecoder::SetSampleRate(uint32_t rate)
 {
-	MagnitudeVectorType magnitude;
-	ComputeMagnitudeVector(rawSamples,magnitude);
-	DetectMessage(magnitude);
+	const DemodTable* table = GetDemodTable(rate);
+	if (table == NULL) {
+		return false;
+	}
+	demodTable = table;
+	sampleClock.SetSampleRate(rate);
+	if (rate != MODES_SAMPLING_2000K) {
+		demodulator = MultiPhaseDemodulator;
+	}
+	ResetStream();
+	return true;
 }
 
-void ADS_BDecoder::ComputeMagnitudeVector(uint8_t* rawSamples,
-		                                  MagnitudeVectorType& magnitude)
+bool ADS_BDecoder::SetDemodulator(DemodulatorType type)
 {
-    uint32_t j;
+	if (type >= DemodulatorCount ||
+		(type == ClassicDemodulator && demodTable->sampleRate != MODES_SAMPLING_2000K)) {
+		return false;
+	}
+	demodulator = type;
+	return true;
+}
 
-    for (j = 0; j < 2048; j += 2) {
-        int i = rawSamples[j]-127;
-        int q = rawSamples[j+1]-127;
+void ADS_BDecoder::SetPreambleFilter(bool enable)
+{
+	preambleFilter = enable;
+}
 
-        if (i < 0) i = -i;
-        if (q < 0) q = -q;
-        magnitude[j/2] = maglut[i*129+q];
-    }
+bool ADS_BDecoder::SetCrcEngine(CrcEngineType type)
+{
+	const CrcEngine* engine = ::GetCrcEngine(type);
+	if (engine == NULL) {
+		return false;
+	}
+	crcEngine = engine;
+	incrementalCrc = (type == CrcTableEngine);
+	return true;
+}
 
+void ADS_BDecoder::SetCrcCorrection(CrcCorrection policy)
+{
+	crcCorrection = policy;
 }
 
-void ADS_BDecoder::InitMagnitudeLUT()
+void ADS_BDecoder::SetStreamingMode(bool enable)
 {
-    for (uint8_t i = 0; i <= 128; i++) {
-        for (uint8_t q = 0; q <= 128; q++) {
-        	magnitudeLUT[i*129+q] = round(sqrt(i*i+q*q)*360);
-        }
-    }
+	streamingMode = enable;
+	ResetStream();
+}
+
+void ADS_BDecoder::ResetStream()
+{
+	magnitude.fill(0);
+	scanResume = 0;
+}
+
+void ADS_BDecoder::ResetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+void ADS_BDecoder::ProcessRawSamples(const uint8_t* rawSamples)
+{
+	bufferStart = sampleClock.Advance(MODES_MAGNITUDE_SAMPLES);
+	clockEpoch = sampleClock.GetEpoch();
+	Demodulate(rawSamples);
+}
+
+void ADS_BDecoder::ProcessRawSamples(const uint8_t* rawSamples, const SampleBufferTime& time)
+{
+	if (time.afterGap) {
+		ResetStream();
+	}
+	bufferStart = sampleClock.Advance(MODES_MAGNITUDE_SAMPLES, time);
+	clockEpoch = sampleClock.GetEpoch();
+	Demodulate(rawSamples);
+}
+
+void ADS_BDecoder::Demodulate(const uint8_t* rawSamples)
+{
+	uint32_t start = CycleCounterNow();
+	if (streamingMode) {
+		/* The last samples of the previous buffer become the history. */
+		memcpy(magnitude.data(),
+			   magnitude.data() + MODES_MAGNITUDE_SAMPLES,
+			   MODES_MAGNITUDE_HISTORY * sizeof(uint16_t));
+	}
+	ComputeMagnitudeVector(rawSamples,magnitude);
+	uint32_t magnitudeDone = CycleCounterNow();
+
+	if (streamingMode) {
+		/* Scan one buffer worth of offsets. A message decoded near the end
+		 * may extend the scan past the limit, continue after it. */
+		uint32_t next = (demodulator == MultiPhaseDemodulator) ?
+			DetectMessageMultiPhase(magnitude, scanResume, MODES_MAGNITUDE_SAMPLES) :
+			DetectMessage(magnitude, scanResume, MODES_MAGNITUDE_SAMPLES);
+		scanResume = next - MODES_MAGNITUDE_SAMPLES;
+	} else if (demodulator == MultiPhaseDemodulator) {
+		DetectMessageMultiPhase(magnitude, MODES_MAGNITUDE_HISTORY,
+								magnitude.size() - DemodReach(demodTable->halfBitFifths));
+	} else {
+		DetectMessage(magnitude, MODES_MAGNITUDE_HISTORY,
+					  magnitude.size() - MODES_FULL_LEN*2);
+	}
+	uint32_t detectDone = CycleCounterNow();
+
+	stats.buffers++;
+	stats.magnitudeTicks += magnitudeDone - start;
+	stats.detectTicks += detectDone - magnitudeDone;
+}
+
+void ADS_BDecoder::ComputeMagnitudeVector(const uint8_t* rawSamples,
+		                                  MagnitudeVectorType& magnitude)
+{
+    uint16_t* m = magnitude.data() + MODES_MAGNITUDE_HISTORY;
+
+    magnitudeKernel->compute(rawSamples, m, MODES_MAGNITUDE_SAMPLES);
 }
 
 bool ADS_BDecoder::CheckIfPreambleCorrect(MagnitudeVectorType& magnitude, const size_t& idx)
@@ -145,256 +235,143 @@ int ADS_BDecoder::MessageLenByType(int type) {
         return MODES_SHORT_MSG_BITS;
 }
 
-int ADS_BDecoder::DecodeAC12Field(unsigned char *msg, int *unit) {
-    int q_bit = msg[5] & 1;
-
-    if (q_bit) {
-        /* N is the 11 bit integer resulting from the removal of bit
-         * Q */
-        *unit = MODES_UNIT_FEET;
-        int n = ((msg[5]>>1)<<4) | ((msg[6]&0xF0) >> 4);
-        /* The final altitude is due to the resulting number multiplied
-         * by 25, minus 1000. */
-        return n*25-1000;
-    } else {
-        return 0;
-    }
-}
-
-int ADS_BDecoder::DecodeAC13Field(unsigned char *msg, int *unit) {
-    int m_bit = msg[3] & (1<<6);
-    int q_bit = msg[3] & (1<<4);
-
-    if (!m_bit) {
-        *unit = MODES_UNIT_FEET;
-        if (q_bit) {
-            /* N is the 11 bit integer resulting from the removal of bit
-             * Q and M */
-            int n = ((msg[2]&31)<<6) |
-                    ((msg[3]&0x80)>>2) |
-                    ((msg[3]&0x20)>>1) |
-                     (msg[3]&15);
-            /* The final altitude is due to the resulting number multiplied
-             * by 25, minus 1000. */
-            return n*25-1000;
-        } else {
-            /* TODO: Implement altitude where Q=0 and M=0 */
-        }
-    } else {
-        *unit = MODES_UNIT_METERS;
-        /* TODO: Implement altitude when meter unit is selected. */
-    }
-    return 0;
-}
-
-uint32_t ADS_BDecoder::CalcMsgChecksum(unsigned char *msg, int bits) {
-    uint32_t crc = 0;
-    int offset = (bits == 112) ? 0 : (112-56);
-    int j;
-
-    for(j = 0; j < bits; j++) {
-        int byte = j/8;
-        int bit = j%8;
-        int bitmask = 1 << (7-bit);
-
-        /* If bit is set, xor with corresponding table entry. */
-        if (msg[byte] & bitmask)
-            crc ^= modes_checksum_table[j+offset];
-    }
-    return crc; /* 24 bit checksum. */
-}
-
-int ADS_BDecoder::FixSingleBitErrors(unsigned char *msg, int bits) {
-    int j;
-    unsigned char aux[MODES_LONG_MSG_BITS/8];
-
-    for (j = 0; j < bits; j++) {
-        int byte = j/8;
-        int bitmask = 1 << (7-(j%8));
-        uint32_t crc1, crc2;
-
-        memcpy(aux,msg,bits/8);
-        aux[byte] ^= bitmask; /* Flip j-th bit. */
-
-        crc1 = ((uint32_t)aux[(bits/8)-3] << 16) |
-               ((uint32_t)aux[(bits/8)-2] << 8) |
-                (uint32_t)aux[(bits/8)-1];
-        crc2 = CalcMsgChecksum(aux,bits);
-
-        if (crc1 == crc2) {
-            /* The error is fixed. Overwrite the original buffer with
-             * the corrected sequence, and returns the error bit
-             * position. */
-            memcpy(msg,aux,bits/8);
-            return j;
-        }
-    }
-    return -1;
-}
-void ADS_BDecoder::DecodeMessage(ADS_BMessage* mm)
+/* Checks the CRC of mm->msg, fixing bit errors when possible, and publishes
+ * the frame. No field is extracted here: the record carries the raw bits
+ * and the consumer decodes what it needs through the ADS_BMessage
+ * accessors, outside of the acquisition task. */
+void ADS_BDecoder::DecodeMessage(ADS_BMessage* mm, uint32_t crc2)
 {
-    uint32_t crc2;   /* Computed CRC, used to verify the message CRC. */
-    char ais_charset[] = "?ABCDEFGHIJKLMNOPQRSTUVWXYZ????? ???????????????0123456789??????";
-
     unsigned char* msg = mm->msg;
-    /* Work on our local copy */
-    //msg = mm->msg;
 
     /* Get the message type ASAP as other operations depend on this */
-    mm->msgtype = msg[0]>>3;    /* Downlink Format */
-    mm->msgbits = MessageLenByType(mm->msgtype);
+    int msgtype = msg[0]>>3;    /* Downlink Format */
+    int msgbits = MessageLenByType(msgtype);
+    mm->msgtype = msgtype;
+    mm->longFrame = (msgbits == MODES_LONG_MSG_BITS);
 
     /* CRC is always the last three bytes. */
-    mm->crc = ((uint32_t)msg[(mm->msgbits/8)-3] << 16) |
-              ((uint32_t)msg[(mm->msgbits/8)-2] << 8) |
-               (uint32_t)msg[(mm->msgbits/8)-1];
-    crc2 = CalcMsgChecksum(msg,mm->msgbits);
-
-    /* Check CRC and fix single bit errors using the CRC when
-     * possible (DF 11 and 17). */
-    mm->errorbit = -1;  /* No error */
-    mm->crcok = (mm->crc == crc2);
-
-    if (!mm->crcok &&
-         (mm->msgtype == 17))
+    uint32_t crc = ((uint32_t)msg[(msgbits/8)-3] << 16) |
+                   ((uint32_t)msg[(msgbits/8)-2] << 8) |
+                    (uint32_t)msg[(msgbits/8)-1];
+
+    /* Check CRC and fix bit errors using the CRC syndrome when
+     * possible. Only DF 17 is published, so only DF 17 is worth fixing:
+     * DF 11 could be repaired the same way but would be dropped anyway. */
+    mm->crcStatus = (crc == crc2) ? CrcStatusOk : CrcStatusBad;
+
+    if (mm->crcStatus == CrcStatusBad && crcCorrection != CrcCorrectionOff &&
+         msgtype == 17)
      {
-         if ((mm->errorbit = FixSingleBitErrors(msg,mm->msgbits)) != -1) {
-             mm->crc = CalcMsgChecksum(msg,mm->msgbits);
-             mm->crcok = 1;
-         }else
+         uint32_t syndrome = crc ^ crc2;
+         int maxErrors = (crcCorrection == CrcCorrectionTwoBits) ? 2 : 1;
+         int errorBits[2];
+         int fixed = ModeSFixErrors(msg,msgbits,syndrome,maxErrors,errorBits);
+
+         if (fixed == 1) {
+             mm->crcStatus = CrcStatusFixedOneBit;
+             stats.framesFixedOneBit++;
+         } else if (fixed) {
+             mm->crcStatus = CrcStatusFixedTwoBits;
+             stats.framesFixedTwoBits++;
+         } else
          {
-        	 xQueueSend(messageQueue, mm, portMAX_DELAY);
+        	 stats.framesQueued++;
+        	 messageBus.Publish(*mm);
         	 return;
          }
      }
 
-    /* Note that most of the other computation happens *after* we fix
-        * the single bit errors, otherwise we would need to recompute the
-        * fields again. */
-       mm->ca = msg[0] & 7;        /* Responder capabilities. */
-
-       /* ICAO address */
-       mm->aa1 = msg[1];
-       mm->aa2 = msg[2];
-       mm->aa3 = msg[3];
-
-       /* DF 17 type (assuming this is a DF17, otherwise not used) */
-       mm->metype = msg[4] >> 3;   /* Extended squitter message type. */
-       mm->mesub = msg[4] & 7;     /* Extended squitter message subtype. */
-
-       /* Fields for DF4,5,20,21 */
-       mm->fs = msg[0] & 7;        /* Flight status for DF4,5,20,21 */
-       mm->dr = msg[1] >> 3 & 31;  /* Request extraction of downlink request. */
-       mm->um = ((msg[1] & 7)<<3)| /* Request extraction of downlink request. */
-                 msg[2]>>5;
-
-       /* In the squawk (identity) field bits are interleaved like that
-        * (message bit 20 to bit 32):
-        *
-        * C1-A1-C2-A2-C4-A4-ZERO-B1-D1-B2-D2-B4-D4
-        *
-        * So every group of three bits A, B, C, D represent an integer
-        * from 0 to 7.
-        *
-        * The actual meaning is just 4 octal numbers, but we convert it
-        * into a base ten number tha happens to represent the four
-        * octal numbers.
-        *
-        * For more info: http://en.wikipedia.org/wiki/Gillham_code */
-       {
-           int a,b,c,d;
-
-           a = ((msg[3] & 0x80) >> 5) |
-               ((msg[2] & 0x02) >> 0) |
-               ((msg[2] & 0x08) >> 3);
-           b = ((msg[3] & 0x02) << 1) |
-               ((msg[3] & 0x08) >> 2) |
-               ((msg[3] & 0x20) >> 5);
-           c = ((msg[2] & 0x01) << 2) |
-               ((msg[2] & 0x04) >> 1) |
-               ((msg[2] & 0x10) >> 4);
-           d = ((msg[3] & 0x01) << 2) |
-               ((msg[3] & 0x04) >> 1) |
-               ((msg[3] & 0x10) >> 4);
-           mm->identity = a*1000 + b*100 + c*10 + d;
-       }
-
-       /* Decode 13 bit altitude for DF0, DF4, DF16, DF20 */
-       if (mm->msgtype == 0 || mm->msgtype == 4 ||
-           mm->msgtype == 16 || mm->msgtype == 20) {
-           mm->altitude = DecodeAC13Field(msg, &mm->unit);
-
-       }
-
-       /* Decode extended squitter specific stuff. */
-       if (mm->msgtype == 17) {
-           /* Decode the extended squitter message. */
-
-           if (mm->metype >= 1 && mm->metype <= 4) {
-               /* Aircraft Identification and Category */
-               mm->aircraft_type = mm->metype-1;
-               mm->flight[0] = ais_charset[msg[5]>>2];
-               mm->flight[1] = ais_charset[((msg[5]&3)<<4)|(msg[6]>>4)];
-               mm->flight[2] = ais_charset[((msg[6]&15)<<2)|(msg[7]>>6)];
-               mm->flight[3] = ais_charset[msg[7]&63];
-               mm->flight[4] = ais_charset[msg[8]>>2];
-               mm->flight[5] = ais_charset[((msg[8]&3)<<4)|(msg[9]>>4)];
-               mm->flight[6] = ais_charset[((msg[9]&15)<<2)|(msg[10]>>6)];
-               mm->flight[7] = ais_charset[msg[10]&63];
-               mm->flight[8] = '\0';
-           } else if (mm->metype >= 9 && mm->metype <= 18) {
-               /* Airborne position Message */
-               mm->fflag = msg[6] & (1<<2);
-               mm->tflag = msg[6] & (1<<3);
-               mm->altitude = DecodeAC12Field(msg,&mm->unit);
-               mm->raw_latitude = ((msg[6] & 3) << 15) |
-                                   (msg[7] << 7) |
-                                   (msg[8] >> 1);
-               mm->raw_longitude = ((msg[8]&1) << 16) |
-                                    (msg[9] << 8) |
-                                    msg[10];
-
-           } else if (mm->metype == 19 && mm->mesub >= 1 && mm->mesub <= 4) {
-               /* Airborne Velocity Message */
-               if (mm->mesub == 1 || mm->mesub == 2) {
-                   mm->ew_dir = (msg[5]&4) >> 2;
-                   mm->ew_velocity = ((msg[5]&3) << 8) | msg[6];
-                   mm->ns_dir = (msg[7]&0x80) >> 7;
-                   mm->ns_velocity = ((msg[7]&0x7f) << 3) | ((msg[8]&0xe0) >> 5);
-                   mm->vert_rate_source = (msg[8]&0x10) >> 4;
-                   mm->vert_rate_sign = (msg[8]&0x8) >> 3;
-                   mm->vert_rate = ((msg[8]&7) << 6) | ((msg[9]&0xfc) >> 2);
-                   /* Compute velocity and angle from the two speed
-                    * components. */
-                   mm->velocity = sqrt(mm->ns_velocity*mm->ns_velocity+
-                                       mm->ew_velocity*mm->ew_velocity);
-                   if (mm->velocity) {
-                       int ewv = mm->ew_velocity;
-                       int nsv = mm->ns_velocity;
-
-                       if (mm->ew_dir) ewv *= -1;
-                       if (mm->ns_dir) nsv *= -1;
-                       mm->heading = atan2(ewv,nsv);
-
-
-                   } else {
-                       mm->heading = 0.0F;
-                   }
-               } else if (mm->mesub == 3 || mm->mesub == 4) {
-                   mm->heading_is_valid = msg[5] & (1<<2);
-                   mm->heading = (360.0/128.0) * float(((msg[5] & 3) << 5) |
-                                                 (msg[6] >> 3));
-               }
-           }
-           xQueueSend(messageQueue, mm, portMAX_DELAY);
-       }
-       mm->phase_corrected = 0; /* Set to 1 by the caller if needed. */
-
-    return;
+    if (mm->CrcOk()) stats.framesCrcOk++;
+
+    /* Only extended squitters are of interest to the consumer. */
+    if (msgtype == 17) {
+        stats.framesQueued++;
+        messageBus.Publish(*mm);
+    }
 }
-void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
+
+/* Builds candidateMask for the offsets [begin, end). */
+void ADS_BDecoder::FindPreambleCandidates(const uint16_t* m, uint32_t begin, uint32_t end)
+{
+    /* Bit k of the edge mask is set when sample k is above sample k+1. The
+     * full check needs m[j] > m[j+1], m[j+1] < m[j+2], m[j+2] > m[j+3],
+     * m[j+7] > m[j+8] and m[j+8] < m[j+9], so a preamble at j requires
+     * edges at j, j+2, j+7 and none at j+1, j+8 - the 1010000101 pulse
+     * pattern. Candidates are a superset of what the full check accepts,
+     * nothing is lost, and 32 positions are tested per word operation. */
+    uint32_t firstWord = begin / 32;
+    uint32_t lastWord = (end + 31) / 32;
+    uint32_t w, b;
+
+    for (w = firstWord; w <= lastWord; w++) {
+        const uint16_t* s = m + w * 32;
+        uint32_t edges = 0;
+        for (b = 0; b < 32; b++)
+            edges |= (uint32_t)(s[b] > s[b+1]) << b;
+        edgeMask[w] = edges;
+    }
+    for (w = firstWord; w < lastWord; w++) {
+        uint64_t e = edgeMask[w] | ((uint64_t)edgeMask[w+1] << 32);
+        candidateMask[w] = (uint32_t)(e & ~(e >> 1) & (e >> 2) & (e >> 7) & ~(e >> 8));
+    }
+}
+
+/* Rate independent prefilter for the multi-phase demodulator: the first
+ * relations of DemodCheckPreamble at phase 0 (e0 > e1 < e2 > e3 and
+ * e7 > e8 < e9) evaluated without branches, one candidate bit per
+ * position, so the full check again only runs where they hold. */
+void ADS_BDecoder::FindPreambleCandidatesWindowed(const uint16_t* m, uint32_t begin, uint32_t end)
+{
+    /* Local copies, the byte sized weights could otherwise alias the mask. */
+    const DemodWindow* w = demodTable->preamble[0];
+    const uint32_t o0 = w[0].offset, o1 = w[1].offset, o2 = w[2].offset, o3 = w[3].offset;
+    const uint32_t o7 = w[7].offset, o8 = w[8].offset, o9 = w[9].offset;
+    const int a0 = w[0].weight[0], b0 = w[0].weight[1], a1 = w[1].weight[0], b1 = w[1].weight[1];
+    const int a2 = w[2].weight[0], b2 = w[2].weight[1], a3 = w[3].weight[0], b3 = w[3].weight[1];
+    const int a7 = w[7].weight[0], b7 = w[7].weight[1], a8 = w[8].weight[0], b8 = w[8].weight[1];
+    const int a9 = w[9].weight[0], b9 = w[9].weight[1];
+    uint32_t firstWord = begin / 32;
+    uint32_t lastWord = (end + 31) / 32;
+    uint32_t wd, b;
+
+    for (wd = firstWord; wd < lastWord; wd++) {
+        const uint16_t* s = m + wd * 32;
+        uint8_t hit[32];
+        uint32_t bits = 0;
+        /* Compare and pack in separate loops, the first one vectorizes. */
+        for (b = 0; b < 32; b++) {
+            int e0 = a0*s[b+o0] + b0*s[b+o0+1];
+            int e1 = a1*s[b+o1] + b1*s[b+o1+1];
+            int e2 = a2*s[b+o2] + b2*s[b+o2+1];
+            int e3 = a3*s[b+o3] + b3*s[b+o3+1];
+            int e7 = a7*s[b+o7] + b7*s[b+o7+1];
+            int e8 = a8*s[b+o8] + b8*s[b+o8+1];
+            int e9 = a9*s[b+o9] + b9*s[b+o9+1];
+            hit[b] = (e0 > e1) & (e2 > e1) & (e2 > e3) & (e7 > e8) & (e9 > e8);
+        }
+        for (b = 0; b < 32; b++)
+            bits |= (uint32_t)hit[b] << b;
+        candidateMask[wd] = bits;
+    }
+}
+
+uint32_t ADS_BDecoder::NextPreambleCandidate(uint32_t j, uint32_t end)
+{
+    uint32_t w = j / 32;
+    uint32_t bits = candidateMask[w] & (~0UL << (j % 32));
+
+    while (bits == 0) {
+        if (++w * 32 >= end) return end;
+        bits = candidateMask[w];
+    }
+    return w * 32 + __builtin_ctz(bits);
+}
+
+/* Scans candidate preamble offsets [begin, end) of the magnitude vector and
+ * returns the offset the scan stopped at, which is past end when the last
+ * message decoded extends beyond it. */
+uint32_t ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude, uint32_t begin, uint32_t end)
 {
-	unsigned char bits[MODES_LONG_MSG_BITS];
 	unsigned char msg[MODES_LONG_MSG_BITS/2];
 	uint16_t aux[MODES_LONG_MSG_BITS*2];
 	uint16_t* m = magnitude.data();
@@ -424,12 +401,25 @@ void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
 	     * 8   --
 	     * 9   -------------------
 	     */
-	    for (j = 0; j < magnitude.size() - MODES_FULL_LEN*2; j++) {
+	    if (preambleFilter) {
+	        uint32_t prefilterStart = CycleCounterNow();
+	        FindPreambleCandidates(m, begin, end);
+	        stats.prefilterTicks += CycleCounterNow() - prefilterStart;
+	    }
+
+	    for (j = begin; j < end; j++) {
 	        int low, high, delta, i, errors;
 	        int good_message = 0;
 
 	        if (use_correction) goto good_preamble; /* We already checked it. */
 
+	        /* Jump straight to the next position the prefilter let through. */
+	        if (preambleFilter) {
+	            j = NextPreambleCandidate(j, end);
+	            if (j >= end) break;
+	        }
+	        stats.preambleChecks++;
+
 	        /* First check of relations between the first 10 samples
 	         * representing a valid preamble. We don't even investigate further
 	         * if this simple test is not passed. */
@@ -468,6 +458,7 @@ void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
 	        {
 	            continue;
 	        }
+	        stats.preambles++;
 
 	good_preamble:
 	        /* If the previous attempt with this message failed, retry using
@@ -480,59 +471,86 @@ void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
 	            /* TODO ... apply other kind of corrections. */
 	        }
 
-	        /* Decode all the next 112 bits, regardless of the actual message
-	         * size. We'll check the actual message type later. */
+	        /* Slice the bits straight into msg[], accumulating the CRC of the
+	         * data bytes and the delta used by the noise filter below in the
+	         * same pass. The delta is taken on the uncorrected samples, saved
+	         * in aux[] when magnitude correction is active. The frame length
+	         * is known after the five downlink format bits, so short frames
+	         * stop at 56 bits, and the slicing is abandoned as soon as the
+	         * frame can't be decoded anyway: a bit error in the first 56 bits
+	         * or a downlink format no transponder sends. */
+	        const uint16_t* p = m+j+MODES_PREAMBLE_US*2;
+	        const uint16_t* orig = use_correction ? aux : p;
+	        int bit = 0, byte = 0;
+	        int nbits = MODES_LONG_MSG_BITS;
+	        int msgtype = 0;
+	        int msglen = MODES_LONG_MSG_BYTES;
+	        uint32_t crc = 0;
+	        uint32_t level = 0;
 	        errors = 0;
-	        for (i = 0; i < MODES_LONG_MSG_BITS*2; i += 2) {
-	            low = m[j+i+MODES_PREAMBLE_US*2];
-	            high = m[j+i+MODES_PREAMBLE_US*2+1];
-	            delta = low-high;
-	            if (delta < 0) delta = -delta;
-
-	            if (i > 0 && delta < 256) {
-	                bits[i/2] = bits[i/2-1];
+	        delta = 0;
+	        uint32_t sliceStart = CycleCounterNow();
+	        for (i = 0; i < nbits; i++) {
+	            low = p[2*i];
+	            high = p[2*i+1];
+	            delta += abs(orig[2*i]-orig[2*i+1]);
+	            /* The pulse ("1" chip) of a PPM bit is its stronger half. */
+	            level += (orig[2*i] > orig[2*i+1]) ? orig[2*i] : orig[2*i+1];
+
+	            if (i > 0 && abs(low-high) < 256) {
+	                /* Same as the previous bit. */
 	            } else if (low == high) {
 	                /* Checking if two adiacent samples have the same magnitude
 	                 * is an effective way to detect if it's just random noise
 	                 * that was detected as a valid preamble. */
-	                bits[i/2] = 2; /* error */
-	                if (i < MODES_SHORT_MSG_BITS*2) errors++;
-	            } else if (low > high) {
-	                bits[i/2] = 1;
+	                bit = 2; /* error */
+	                if (i < MODES_SHORT_MSG_BITS) {
+	                    errors++;
+	                    break;
+	                }
 	            } else {
-	                /* (low < high) for exclusion  */
-	                bits[i/2] = 0;
+	                bit = low > high;
+	            }
+	            /* An error bit past the first 56 is packed as before, it
+	             * spills into the neighbouring bit and fails the CRC. */
+	            byte |= bit << (7-(i&7));
+
+	            if (i == 4) {
+	                msgtype = byte>>3;
+	                if (!(MODES_DF_PLAUSIBLE & (1u << msgtype))) {
+	                    errors++;
+	                    break;
+	                }
+	                msglen = MessageLenByType(msgtype)/8;
+	                nbits = msglen*8;
+	            }
+	            if ((i&7) == 7) {
+	                msg[i/8] = (unsigned char)byte;
+	                if (incrementalCrc && i/8 < msglen-3)
+	                    crc = ModeSCrcUpdate(crc, msg[i/8]);
+	                byte = 0;
 	            }
 	        }
 
+	        stats.sliceTicks += CycleCounterNow() - sliceStart;
+
 	        /* Restore the original message if we used magnitude correction. */
 	        if (use_correction)
 	            memcpy(m+j+MODES_PREAMBLE_US*2,aux,sizeof(aux));
 
-	        /* Pack bits into bytes */
-	        for (i = 0; i < MODES_LONG_MSG_BITS; i += 8) {
-	            msg[i/8] =
-	                bits[i]<<7 |
-	                bits[i+1]<<6 |
-	                bits[i+2]<<5 |
-	                bits[i+3]<<4 |
-	                bits[i+4]<<3 |
-	                bits[i+5]<<2 |
-	                bits[i+6]<<1 |
-	                bits[i+7];
-	        }
-
-	        int msgtype = msg[0]>>3;
-	        int msglen = MessageLenByType(msgtype)/8;
-
 	        /* Last check, high and low bits are different enough in magnitude
-	         * to mark this as real message and not just noise? */
-	        delta = 0;
-	        for (i = 0; i < msglen*8*2; i += 2) {
-	            delta += abs(m[j+i+MODES_PREAMBLE_US*2]-
-	                         m[j+i+MODES_PREAMBLE_US*2+1]);
+	         * to mark this as real message and not just noise? A frame that
+	         * was abandoned is judged on the bits seen so far: a strong one
+	         * still gets the retry with phase correction. */
+	        if (i < nbits) {
+	            stats.earlyRejects++;
+	            delta = delta*2/(i+1);
+	        } else {
+	            delta /= msglen*4;
+	            if (msglen == MODES_SHORT_MSG_BYTES)
+	                memset(msg+MODES_SHORT_MSG_BYTES,0,
+	                       MODES_LONG_MSG_BYTES-MODES_SHORT_MSG_BYTES);
 	        }
-	        delta /= msglen*4;
 
 	        /* Filter for an average delta of three is small enough to let almost
 	         * every kind of message to pass, but high enough to filter some
@@ -547,17 +565,25 @@ void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
         if (errors == 0) {
         	ADS_BMessage mm;
         	memcpy(mm.msg,msg,MODES_LONG_MSG_BYTES);
+        	mm.SetTimestamp(bufferStart + j - MODES_MAGNITUDE_HISTORY);
+        	mm.clockEpoch = clockEpoch;
+        	mm.signalLevel = level/nbits;
             /* Decode the received message and update statistics */
-            DecodeMessage(&mm);
+        	uint32_t decodeStart = CycleCounterNow();
+        	if (!incrementalCrc)
+        	    crc = crcEngine->checksum(msg, msglen*8);
+            DecodeMessage(&mm, crc);
+            stats.decodeTicks += CycleCounterNow() - decodeStart;
+            stats.frames++;
 
 
             /* Skip this message if we are sure it's fine. */
-            if (mm.crcok) {
+            if (mm.CrcOk()) {
+                if (streamingMode && j < MODES_MAGNITUDE_HISTORY)
+                    stats.framesAcrossSeam++;
 
                 j += (MODES_PREAMBLE_US+(msglen*8))*2;
                 good_message = 1;
-                if (use_correction)
-                    mm.phase_corrected = 1;
             }
 
             /* Pass data to the next layer */
@@ -571,4 +597,137 @@ void ADS_BDecoder::DetectMessage(MagnitudeVectorType& magnitude)
             use_correction = false;
         }
     }
+    return j;
+}
+
+/* Multi-phase counterpart of DetectMessage. Every position is checked for
+ * a preamble at phase 0, then the frame is sliced at MODES_DEMOD_PHASES
+ * sub-sample phases centred on it, -2/5 to +2/5 of a sample apart. Each
+ * hypothesis is scored by its summed bit correlation over the first 56
+ * bits and only the best one is completed and decoded: the magnitudes are
+ * never modified and there is no retry. */
+uint32_t ADS_BDecoder::DetectMessageMultiPhase(MagnitudeVectorType& magnitude, uint32_t begin, uint32_t end)
+{
+    const DemodTable& table = *demodTable;
+    const uint16_t* m = magnitude.data();
+    unsigned char msg[MODES_LONG_MSG_BYTES];
+    unsigned char best[MODES_LONG_MSG_BYTES];
+    uint32_t j;
+
+    /* The edge mask encodes the 2 MS/s sample pattern, other rates use the
+     * window form of the same relations. */
+    if (preambleFilter) {
+        uint32_t prefilterStart = CycleCounterNow();
+        if (table.sampleRate == MODES_SAMPLING_2000K)
+            FindPreambleCandidates(m, begin, end);
+        else
+            FindPreambleCandidatesWindowed(m, begin, end);
+        stats.prefilterTicks += CycleCounterNow() - prefilterStart;
+    }
+
+    for (j = begin; j < end; j++) {
+        int i;
+
+        if (preambleFilter) {
+            j = NextPreambleCandidate(j, end);
+            if (j >= end) break;
+        }
+        stats.preambleChecks++;
+        int pulses = DemodCheckPreamble(m+j, table, 0);
+        if (pulses == 0)
+            continue;
+        stats.preambles++;
+
+        uint32_t sliceStart = CycleCounterNow();
+        int bestScore = -1;
+        int bestShift = 0;
+        uint32_t bestStart = 0;
+        uint32_t bestPhase = 0;
+        for (int shift = -MODES_DEMOD_PHASES/2; shift <= MODES_DEMOD_PHASES/2; shift++) {
+            int at = (int)j*5 + shift;
+            if (at < 0) continue;
+
+            const uint16_t* f = m + at/5;
+            const DemodBit* b = table.bit[at%5];
+            int score = 0;
+            int byte = 0;
+            for (i = 0; i < MODES_SHORT_MSG_BITS; i++) {
+                int c = DemodBitCorrelation(f, b[i]);
+                /* Both halves equal: noise, like low == high above. */
+                if (c == 0) break;
+                byte = (byte << 1) | (c > 0);
+                score += abs(c);
+                if (i == 4 && !(MODES_DF_PLAUSIBLE & (1u << byte))) break;
+                if ((i&7) == 7) {
+                    msg[i/8] = (unsigned char)byte;
+                    byte = 0;
+                }
+            }
+            if (i == MODES_SHORT_MSG_BITS && score > bestScore) {
+                bestScore = score;
+                bestShift = shift;
+                bestStart = at/5;
+                bestPhase = at%5;
+                memcpy(best, msg, MODES_SHORT_MSG_BYTES);
+            }
+        }
+        if (bestScore < 0) {
+            stats.sliceTicks += CycleCounterNow() - sliceStart;
+            stats.earlyRejects++;
+            continue;
+        }
+
+        int msgtype = best[0]>>3;
+        int msglen = MessageLenByType(msgtype)/8;
+        if (msglen == MODES_LONG_MSG_BYTES) {
+            const uint16_t* f = m + bestStart;
+            const DemodBit* b = table.bit[bestPhase];
+            int byte = 0;
+            for (i = MODES_SHORT_MSG_BITS; i < MODES_LONG_MSG_BITS; i++) {
+                int c = DemodBitCorrelation(f, b[i]);
+                byte = (byte << 1) | (c > 0);
+                bestScore += abs(c);
+                if ((i&7) == 7) {
+                    best[i/8] = (unsigned char)byte;
+                    byte = 0;
+                }
+            }
+        } else {
+            memset(best+MODES_SHORT_MSG_BYTES,0,
+                   MODES_LONG_MSG_BYTES-MODES_SHORT_MSG_BYTES);
+        }
+        stats.sliceTicks += CycleCounterNow() - sliceStart;
+
+        /* The noise filter of DetectMessage: the two halves of a bit must
+         * differ by 10*255/2 per sample on average, a window is
+         * halfBitFifths samples wide in fifths. */
+        if (bestScore < (10*255/2) * (int)table.halfBitFifths * msglen*8)
+            continue;
+
+        ADS_BMessage mm;
+        memcpy(mm.msg,best,MODES_LONG_MSG_BYTES);
+        mm.SetTimestamp(bufferStart + bestStart - MODES_MAGNITUDE_HISTORY);
+        mm.clockEpoch = clockEpoch;
+        /* Mean magnitude of the pulse halves of the bits. For each bit the
+         * correlation is pulse minus gap and the energy over the bit pulse
+         * plus gap, bestScore sums the former. */
+        const uint32_t dataStart = bestStart*5 + bestPhase + MODES_PREAMBLE_HALF_BITS*table.halfBitFifths;
+        const uint32_t dataFifths = msglen*8*2*table.halfBitFifths;
+        int dataEnergy = DemodSpanEnergy(m, dataStart, dataStart + dataFifths);
+        mm.signalLevel = (dataEnergy + bestScore) / dataFifths;
+        uint32_t decodeStart = CycleCounterNow();
+        DecodeMessage(&mm, crcEngine->checksum(best, msglen*8));
+        stats.decodeTicks += CycleCounterNow() - decodeStart;
+        stats.frames++;
+
+        /* Skip this message if we are sure it's fine. */
+        if (mm.CrcOk()) {
+            if (streamingMode && j < MODES_MAGNITUDE_HISTORY)
+                stats.framesAcrossSeam++;
+            if (bestShift != 0)
+                stats.framesOffPhase++;
+            j = bestStart + DemodFrameSamples(table, msglen*8) - 1;
+        }
+    }
+    return j;
 }
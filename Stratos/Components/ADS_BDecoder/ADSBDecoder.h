@@ -8,48 +8,164 @@
 #ifndef ADS_BDECODER_ADSBDECODER_H_
 #define ADS_BDECODER_ADSBDECODER_H_
 
-#include "RTLSDR.h"
+#include "RTLSDRConfig.h"
 #include "ADSBMessage.h"
+#include "MagnitudeKernels.h"
+#include "MessageBus.h"
+#include "ModeSCrc.h"
+#include "MultiPhaseDemod.h"
+#include "SampleClock.h"
 #include "cmsis_os.h"
 #include <array>
+#include <cstdint>
 
-#define magnitudeLUTSize 129*129*2
 
 #define MODES_PREAMBLE_US 8       /* microseconds */
-#define MODES_UNIT_FEET 0
-#define MODES_UNIT_METERS 1
 
-typedef std::array<uint16_t,USB_IN_STREAM_SIZE/2> MagnitudeVectorType;
+/* Downlink formats worth demodulating, one bit per DF: 0, 4, 5, 11, 16-21
+ * and 24-31 (the Comm-D formats only use the first two bits as DF). */
+#define MODES_DF_PLAUSIBLE 0xFF3F0831u
 
+/* Number of magnitude samples carried over from the previous buffer in
+ * streaming mode: one full long frame at the highest sample rate, so any
+ * frame starting in the tail of a buffer is still complete once the next
+ * buffer arrives. */
+#define MODES_MAGNITUDE_HISTORY MODES_DEMOD_MAX_REACH
+#define MODES_MAGNITUDE_SAMPLES (USB_IN_STREAM_SIZE/2)
+/* The history is copied from the end of the buffer before it. */
+static_assert(MODES_MAGNITUDE_SAMPLES >= MODES_MAGNITUDE_HISTORY,
+              "USB_IN_STREAM_SIZE is too small to carry the history over");
+/* One bit per magnitude sample, plus a word of look-ahead for the pattern. */
+#define MODES_PREAMBLE_MASK_WORDS ((MODES_MAGNITUDE_HISTORY+MODES_MAGNITUDE_SAMPLES+31)/32+1)
+
+/* Layout: [history][samples of the current USB buffer]. */
+typedef std::array<uint16_t,MODES_MAGNITUDE_HISTORY+MODES_MAGNITUDE_SAMPLES> MagnitudeVectorType;
+
+/* Decoder counters. Tick fields are in CycleCounter units (CPU cycles on
+ * the target, nanoseconds on the host build). */
+struct ADS_BDecoderStats
+{
+	uint32_t buffers;           /* Raw sample buffers processed. */
+	uint32_t preambleChecks;    /* Positions that went through the full preamble check. */
+	uint32_t preambles;         /* Candidates that passed the preamble check. */
+	uint32_t earlyRejects;      /* Candidates abandoned before the last bit. */
+	uint32_t frames;            /* Frames handed over to DecodeMessage. */
+	uint32_t framesCrcOk;       /* Frames with valid (or fixed) CRC. */
+	uint32_t framesFixedOneBit; /* Frames repaired by flipping one bit. */
+	uint32_t framesFixedTwoBits;/* Frames repaired by flipping two bits. */
+	uint32_t framesQueued;      /* Frames published on the message bus. */
+	uint32_t framesAcrossSeam;  /* Good frames starting in the carried history. */
+	uint32_t framesOffPhase;    /* Good frames sliced at another phase than the preamble's. */
+	uint64_t magnitudeTicks;    /* Time spent in ComputeMagnitudeVector. */
+	uint64_t detectTicks;       /* Time spent in DetectMessage, decode included. */
+	uint64_t prefilterTicks;    /* Time spent building the preamble candidate mask. */
+	uint64_t sliceTicks;        /* Time spent slicing candidate frames into bits. */
+	uint64_t decodeTicks;       /* Time spent in DecodeMessage. */
+};
+
+enum DemodulatorType
+{
+	ClassicDemodulator,     /* 2 MS/s only, phase correction retry on failure. */
+	MultiPhaseDemodulator,  /* Best of several sub-sample bit phases. */
+	DemodulatorCount
+};
 
 class ADS_BDecoder
 {
 public:
-	ADS_BDecoder(QueueHandle_t messageQueue);
+	/* Frames are published on messageBus, timestamped on sampleClock. */
+	ADS_BDecoder(MessageBus& messageBus, SampleClock& sampleClock);
+
+	/* One buffer of USB_IN_STREAM_SIZE bytes, contiguous with the previous
+	 * one (replay). */
+	void ProcessRawSamples(const uint8_t* rawSamples);
+	/* A buffer stamped by the driver: after a gap the stream is reset and
+	 * the sample clock skips the lost samples. */
+	void ProcessRawSamples(const uint8_t* rawSamples, const SampleBufferTime& time);
+
+	/* In streaming mode (default) consecutive buffers are treated as one
+	 * continuous stream: the tail of the previous magnitude buffer is kept
+	 * in front of the new one, so every sample offset is a candidate
+	 * preamble and frames straddling two USB buffers are not lost. With
+	 * streaming off every buffer is demodulated on its own. */
+	void SetStreamingMode(bool enable);
+	bool IsStreamingMode() const { return streamingMode; }
+	/* Drops the carried history, e.g. after samples were lost. */
+	void ResetStream();
+
+	/* Input sample rate, 2000000 or 2400000 (false otherwise), ADS_B_SAMPLING
+	 * by default. 2.4 MS/s switches to the multi-phase demodulator. Also
+	 * sets the rate of the sample clock. */
+	bool SetSampleRate(uint32_t rate);
+	uint32_t GetSampleRate() const { return demodTable->sampleRate; }
+
+	/* The classic demodulator (default at 2 MS/s) slices at the preamble
+	 * phase and retries with phase correction when the frame fails. The
+	 * multi-phase one slices every candidate at several sub-sample phases
+	 * and keeps the best correlation. False if unsupported at this rate. */
+	bool SetDemodulator(DemodulatorType type);
+	DemodulatorType GetDemodulator() const { return demodulator; }
+
+	/* Selects the I/Q -> magnitude implementation, false if it is not
+	 * available in this build. Defaults to the fastest exact kernel. */
+	bool SetMagnitudeKernel(MagnitudeKernelType type);
+	const MagnitudeKernel& GetMagnitudeKernel() const { return *magnitudeKernel; }
+
+	/* The prefilter (default on) marks positions whose neighbour
+	 * comparisons match the preamble pulse pattern using word wide bit
+	 * operations, only those get the full preamble check. */
+	void SetPreambleFilter(bool enable);
+	bool IsPreambleFilter() const { return preambleFilter; }
+
+	/* Selects the CRC implementation, false if it is not available in this
+	 * build. The default table engine runs incrementally while the bits
+	 * are packed, the others on the complete frame. */
+	bool SetCrcEngine(CrcEngineType type);
+	const CrcEngine& GetCrcEngine() const { return *crcEngine; }
+
+	/* Error correction applied to frames with a bad CRC, 1 bit by default. */
+	void SetCrcCorrection(CrcCorrection policy);
+	CrcCorrection GetCrcCorrection() const { return crcCorrection; }
 
-	void ProcessRawSamples(uint8_t* rawSamples);
+	const ADS_BDecoderStats& GetStats() const { return stats; }
+	void ResetStats();
 
 private:
 
-	void ComputeMagnitudeVector(uint8_t* rawSamples,
+	void Demodulate(const uint8_t* rawSamples);
+	void ComputeMagnitudeVector(const uint8_t* rawSamples,
 			                    MagnitudeVectorType& magnitude);
-	void InitMagnitudeLUT();
 
 	bool CheckIfPreambleCorrect(MagnitudeVectorType& magnitude, const size_t& idx);
-	void DetectMessage(MagnitudeVectorType& magnitude);
+	uint32_t DetectMessage(MagnitudeVectorType& magnitude, uint32_t begin, uint32_t end);
+	uint32_t DetectMessageMultiPhase(MagnitudeVectorType& magnitude, uint32_t begin, uint32_t end);
+	void FindPreambleCandidates(const uint16_t* m, uint32_t begin, uint32_t end);
+	void FindPreambleCandidatesWindowed(const uint16_t* m, uint32_t begin, uint32_t end);
+	uint32_t NextPreambleCandidate(uint32_t j, uint32_t end);
 	int  DetectOutOfPhase(uint16_t *m);
 	void ApplyPhaseCorrection(uint16_t *m);
 	int  MessageLenByType(int type);
-	void DecodeMessage(ADS_BMessage* mm);
+	/* crc2 is the CRC computed over the data bits of mm->msg. */
+	void DecodeMessage(ADS_BMessage* mm, uint32_t crc2);
 
-	int DecodeAC12Field(unsigned char *msg, int *unit);
-	int DecodeAC13Field(unsigned char *msg, int *unit);
-	uint32_t CalcMsgChecksum(unsigned char *msg, int bits);
-	int FixSingleBitErrors(unsigned char *msg, int bits);
-	std::array<uint16_t, magnitudeLUTSize >magnitudeLUT;
-	uint16_t maglut[129*129*2];
+	MessageBus& messageBus;
+	SampleClock& sampleClock;
+	ADS_BDecoderStats stats;
+	const MagnitudeKernel* magnitudeKernel;
+	const DemodTable* demodTable;
+	DemodulatorType demodulator;
+	CrcCorrection crcCorrection;
+	const CrcEngine* crcEngine;
+	bool incrementalCrc;
+	bool preambleFilter;
+	std::array<uint32_t, MODES_PREAMBLE_MASK_WORDS> edgeMask;
+	std::array<uint32_t, MODES_PREAMBLE_MASK_WORDS> candidateMask;
 
-	QueueHandle_t messageQueue;
+	MagnitudeVectorType magnitude;
+	bool streamingMode;
+	uint32_t scanResume;        /* First index to scan in the next buffer. */
+	uint64_t bufferStart;       /* Timestamp of the first sample of the current buffer. */
+	uint8_t clockEpoch;
 };
 
 #endif /* ADS_BDECODER_ADSBDECODER_H_ */
@@ -0,0 +1,141 @@
+/*
+ * ADSBMessage.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "ADSBMessage.h"
+#include "MagnitudeLUT.h"
+#include <cmath>
+
+/* Magnitude of a carrier that swings the 8 bit I/Q samples end to end. */
+#define MODES_SIGNAL_FULL_SCALE (128.0F*MAGNITUDE_SCALE)
+
+float SignalLevelDbfs(float level)
+{
+	if (level <= 0.0F) {
+		return -100.0F;
+	}
+	return 20.0F * log10f(level / MODES_SIGNAL_FULL_SCALE);
+}
+
+float ADS_BMessage::SignalDbfs() const
+{
+	return SignalLevelDbfs(signalLevel);
+}
+
+void ADS_BMessage::Flight(char* flight) const
+{
+	static const char ais_charset[] = "?ABCDEFGHIJKLMNOPQRSTUVWXYZ????? ???????????????0123456789??????";
+
+	flight[0] = ais_charset[msg[5]>>2];
+	flight[1] = ais_charset[((msg[5]&3)<<4)|(msg[6]>>4)];
+	flight[2] = ais_charset[((msg[6]&15)<<2)|(msg[7]>>6)];
+	flight[3] = ais_charset[msg[7]&63];
+	flight[4] = ais_charset[msg[8]>>2];
+	flight[5] = ais_charset[((msg[8]&3)<<4)|(msg[9]>>4)];
+	flight[6] = ais_charset[((msg[9]&15)<<2)|(msg[10]>>6)];
+	flight[7] = ais_charset[msg[10]&63];
+	flight[8] = '\0';
+}
+
+int ADS_BMessage::Altitude(int* unit) const
+{
+	int q_bit = msg[5] & 1;
+
+	if (q_bit) {
+		/* N is the 11 bit integer resulting from the removal of bit Q */
+		*unit = MODES_UNIT_FEET;
+		int n = ((msg[5]>>1)<<4) | ((msg[6]&0xF0) >> 4);
+		/* The final altitude is due to the resulting number multiplied
+		 * by 25, minus 1000. */
+		return n*25-1000;
+	}
+	return 0;
+}
+
+int ADS_BMessage::AltitudeAC13(int* unit) const
+{
+	int m_bit = msg[3] & (1<<6);
+	int q_bit = msg[3] & (1<<4);
+
+	if (!m_bit) {
+		*unit = MODES_UNIT_FEET;
+		if (q_bit) {
+			/* N is the 11 bit integer resulting from the removal of bit
+			 * Q and M */
+			int n = ((msg[2]&31)<<6) |
+					((msg[3]&0x80)>>2) |
+					((msg[3]&0x20)>>1) |
+					 (msg[3]&15);
+			return n*25-1000;
+		} else {
+			/* TODO: Implement altitude where Q=0 and M=0 */
+		}
+	} else {
+		*unit = MODES_UNIT_METERS;
+		/* TODO: Implement altitude when meter unit is selected. */
+	}
+	return 0;
+}
+
+/* In the squawk (identity) field bits are interleaved like that (message
+ * bit 20 to bit 32):
+ *
+ * C1-A1-C2-A2-C4-A4-ZERO-B1-D1-B2-D2-B4-D4
+ *
+ * So every group of three bits A, B, C, D represent an integer from 0 to 7.
+ * The actual meaning is just 4 octal numbers, returned as a base ten number
+ * that happens to represent them.
+ *
+ * For more info: http://en.wikipedia.org/wiki/Gillham_code */
+int ADS_BMessage::Identity() const
+{
+	int a = ((msg[3] & 0x80) >> 5) |
+			((msg[2] & 0x02) >> 0) |
+			((msg[2] & 0x08) >> 3);
+	int b = ((msg[3] & 0x02) << 1) |
+			((msg[3] & 0x08) >> 2) |
+			((msg[3] & 0x20) >> 5);
+	int c = ((msg[2] & 0x01) << 2) |
+			((msg[2] & 0x04) >> 1) |
+			((msg[2] & 0x10) >> 4);
+	int d = ((msg[3] & 0x01) << 2) |
+			((msg[3] & 0x04) >> 1) |
+			((msg[3] & 0x10) >> 4);
+	return a*1000 + b*100 + c*10 + d;
+}
+
+int ADS_BMessage::Velocity() const
+{
+	/* N/S velocity and airspeed share the same bits. */
+	int nsVelocity = ((msg[7]&0x7f) << 3) | ((msg[8]&0xe0) >> 5);
+	if (MeSub() == 3 || MeSub() == 4) {
+		return nsVelocity;
+	}
+	int ewVelocity = ((msg[5]&3) << 8) | msg[6];
+	return sqrt(nsVelocity*nsVelocity + ewVelocity*ewVelocity);
+}
+
+float ADS_BMessage::Heading() const
+{
+	if (MeSub() == 3 || MeSub() == 4) {
+		return (360.0/128.0) * float(((msg[5] & 3) << 5) | (msg[6] >> 3));
+	}
+	int ewVelocity = ((msg[5]&3) << 8) | msg[6];
+	int nsVelocity = ((msg[7]&0x7f) << 3) | ((msg[8]&0xe0) >> 5);
+	if (ewVelocity == 0 && nsVelocity == 0) {
+		return 0.0F;
+	}
+	if (msg[5] & 4) ewVelocity = -ewVelocity;   /* West */
+	if (msg[7] & 0x80) nsVelocity = -nsVelocity; /* South */
+	return atan2(ewVelocity, nsVelocity);
+}
+
+bool ADS_BMessage::HeadingValid() const
+{
+	if (MeSub() == 3 || MeSub() == 4) {
+		return msg[5] & (1<<2);
+	}
+	return Velocity() != 0;
+}
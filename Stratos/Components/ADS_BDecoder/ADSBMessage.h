@@ -8,55 +8,88 @@
 #ifndef ADS_BDECODER_ADSBMESSAGE_H_
 #define ADS_BDECODER_ADSBMESSAGE_H_
 
+#include <cstdint>
+
 #define MODES_LONG_MSG_BITS 112
 #define MODES_SHORT_MSG_BITS 56
 #define MODES_FULL_LEN (MODES_PREAMBLE_US+MODES_LONG_MSG_BITS)
 #define MODES_LONG_MSG_BYTES (112/8)
 #define MODES_SHORT_MSG_BYTES (56/8)
+#define MODES_UNIT_FEET 0
+#define MODES_UNIT_METERS 1
+
+/* CRC state of a frame, after error correction. */
+enum ModeSCrcStatus
+{
+	CrcStatusBad,
+	CrcStatusOk,
+	CrcStatusFixedOneBit,
+	CrcStatusFixedTwoBits
+};
 
+/* One demodulated frame as it travels through the message queue: the raw
+ * bits plus what only the demodulator knows. Everything else is extracted
+ * from msg[] on demand by the accessors, on the consumer side.
+ *
+ * The timestamp counts samples since capture started (SampleClock), taken
+ * at the first preamble pulse. Two timestamps of the same clockEpoch are
+ * sample exact apart; SampleClock converts them to ages and ticks. */
 struct ADS_BMessage
 {
-	 /* Generic fields */
-	    unsigned char msg[MODES_LONG_MSG_BYTES]; /* Binary message. */
-	    int msgbits;                /* Number of bits in message */
-	    int msgtype;                /* Downlink format # */
-	    int crcok;                  /* True if CRC was valid */
-	    uint32_t crc;               /* Message CRC */
-	    int errorbit;               /* Bit corrected. -1 if no bit corrected. */
-	    int aa1, aa2, aa3;          /* ICAO Address bytes 1 2 and 3 */
-	    int phase_corrected;        /* True if phase correction was applied. */
-
-	    /* DF 11 */
-	    int ca;                     /* Responder capabilities. */
-
-	    /* DF 17 */
-	    int metype;                 /* Extended squitter message type. */
-	    int mesub;                  /* Extended squitter message subtype. */
-	    int heading_is_valid;
-	    float heading;
-	    int aircraft_type;
-	    int fflag;                  /* 1 = Odd, 0 = Even CPR message. */
-	    int tflag;                  /* UTC synchronized? */
-	    int raw_latitude;           /* Non decoded latitude */
-	    int raw_longitude;          /* Non decoded longitude */
-	    char flight[9];             /* 8 chars flight number. */
-	    int ew_dir;                 /* 0 = East, 1 = West. */
-	    int ew_velocity;            /* E/W velocity. */
-	    int ns_dir;                 /* 0 = North, 1 = South. */
-	    int ns_velocity;            /* N/S velocity. */
-	    int vert_rate_source;       /* Vertical rate source. */
-	    int vert_rate_sign;         /* Vertical rate sign. */
-	    int vert_rate;              /* Vertical rate. */
-	    int velocity;               /* Computed from EW and NS velocity. */
-
-	    /* DF4, DF5, DF20, DF21 */
-	    int fs;                     /* Flight status for DF4,5,20,21 */
-	    int dr;                     /* Request extraction of downlink request. */
-	    int um;                     /* Request extraction of downlink request. */
-	    int identity;               /* 13 bits identity (Squawk). */
-
-	    /* Fields used by multiple message types. */
-	    int altitude, unit;
+	uint32_t timestampLow;           /* Sample clock at the preamble start, */
+	uint16_t timestampHigh;          /* 48 bits wide. */
+	uint16_t signalLevel;            /* Mean magnitude of the bit pulses ("1" chips). */
+	unsigned char msg[MODES_LONG_MSG_BYTES]; /* Binary message, errors fixed. */
+	uint8_t msgtype : 5;             /* Downlink format # */
+	uint8_t longFrame : 1;           /* 112 bits, 56 otherwise. */
+	uint8_t crcStatus : 2;           /* ModeSCrcStatus */
+	uint8_t clockEpoch;              /* SampleClock epoch, changes after lost samples. */
+
+	uint64_t Timestamp() const { return ((uint64_t)timestampHigh << 32) | timestampLow; }
+	void SetTimestamp(uint64_t t) { timestampLow = (uint32_t)t; timestampHigh = (uint16_t)(t >> 32); }
+	int Bits() const { return longFrame ? MODES_LONG_MSG_BITS : MODES_SHORT_MSG_BITS; }
+	bool CrcOk() const { return crcStatus != CrcStatusBad; }
+	float SignalDbfs() const;
+
+	/* Fields common to all formats. */
+	uint32_t Icao() const { return ((uint32_t)msg[1] << 16) | (msg[2] << 8) | msg[3]; }
+	int Capability() const { return msg[0] & 7; }   /* DF11, DF17 */
+	int FlightStatus() const { return msg[0] & 7; } /* DF4, DF5, DF20, DF21 */
+	int Identity() const;                           /* Squawk, DF5 and DF21. */
+	/* 13 bit altitude of DF0, DF4, DF16, DF20, 0 if unknown. */
+	int AltitudeAC13(int* unit) const;
+
+	/* DF17 extended squitter. */
+	int MeType() const { return msg[4] >> 3; }
+	int MeSub() const { return msg[4] & 7; }
+	bool IsIdentification() const { return MeType() >= 1 && MeType() <= 4; }
+	bool IsAirbornePosition() const { return MeType() >= 9 && MeType() <= 18; }
+	bool IsAirborneVelocity() const { return MeType() == 19 && MeSub() >= 1 && MeSub() <= 4; }
+
+	/* Identification: 8 chars flight number, flight[] holds 9 bytes. */
+	void Flight(char* flight) const;
+
+	/* Airborne position. */
+	int Altitude(int* unit) const;                  /* 12 bit altitude, 0 if unknown. */
+	int CprOdd() const { return msg[6] & (1<<2); }  /* Non zero for odd CPR. */
+	int UtcSync() const { return msg[6] & (1<<3); }
+	int RawLatitude() const { return ((msg[6] & 3) << 15) | (msg[7] << 7) | (msg[8] >> 1); }
+	int RawLongitude() const { return ((msg[8] & 1) << 16) | (msg[9] << 8) | msg[10]; }
+
+	/* Airborne velocity. Ground speed (subtypes 1, 2) comes with a heading
+	 * in radians computed from its components, airspeed (subtypes 3, 4)
+	 * with the transmitted heading in degrees. */
+	int Velocity() const;
+	float Heading() const;
+	bool HeadingValid() const;
+	int VerticalRate() const { return ((msg[8]&7) << 6) | ((msg[9]&0xfc) >> 2); }
+	int VerticalRateSign() const { return (msg[8]&0x8) >> 3; }
 };
 
+/* A magnitude (signalLevel) in dB relative to a full scale carrier,
+ * -100 for 0. */
+float SignalLevelDbfs(float level);
+
+static_assert(sizeof(ADS_BMessage) == 24, "ADS_BMessage is a queue record, keep it small");
+
 #endif /* ADS_BDECODER_ADSBMESSAGE_H_ */
@@ -0,0 +1,343 @@
+/*
+ * MagnitudeKernels.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "MagnitudeKernels.h"
+#include "MagnitudeLUT.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(STM32F767xx)
+#include "stm32f7xx.h"
+#define MAGNITUDE_SIMD32
+#elif defined(MAGNITUDE_SIMD32_EMULATION)
+#include "Simd32Intrinsics.h"
+#define MAGNITUDE_SIMD32
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MAGNITUDE_X86
+#endif
+
+namespace
+{
+
+/* ------------------------------ scalar LUT ------------------------------ */
+
+void MagnitudeLut(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		int i = rawSamples[2*k]-127;
+		int q = rawSamples[2*k+1]-127;
+
+		if (i < 0) i = -i;
+		if (q < 0) q = -q;
+		magnitude[k] = magnitudeLUT.value[i*MAGNITUDE_LUT_SIDE+q];
+	}
+}
+
+void MagnitudeLut8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		int i = rawSamples[2*k]-127;
+		int q = rawSamples[2*k+1]-127;
+
+		if (i < 0) i = -i;
+		if (q < 0) q = -q;
+		magnitude[k] = magnitude8LUT.value[i*MAGNITUDE_LUT_SIDE+q];
+	}
+}
+
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+/* One little endian 16 bit load per I/Q pair indexes the table directly. */
+void MagnitudeRawIQLut(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		uint16_t iq;
+		memcpy(&iq, rawSamples+2*k, sizeof(iq));
+		magnitude[k] = magnitudeRawIQLUT.value[iq];
+	}
+}
+
+void MagnitudeRawIQLut8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		uint16_t iq;
+		memcpy(&iq, rawSamples+2*k, sizeof(iq));
+		magnitude[k] = magnitudeRawIQLUT.value[iq] >> 8;
+	}
+}
+#endif
+
+/* ---------------------------- alpha max beta min ---------------------------- */
+
+/* max*alpha + min*beta with alpha = 0.9604 and beta = 0.3978 (scaled by 360),
+ * the pair that minimises the peak error, which is below 4% of the magnitude. */
+#define AMBM_ALPHA 346
+#define AMBM_BETA 143
+
+inline uint32_t AlphaMaxBetaMin(const uint8_t* pair)
+{
+	/* Noise makes the max/min comparison random, so it is done without a
+	 * branch: hi*alpha + lo*beta == hi*(alpha-beta) + (i+q)*beta. */
+	const int i = abs(pair[0]-127);
+	const int q = abs(pair[1]-127);
+	const int hi = i ^ ((i ^ q) & -(i < q));
+	return uint32_t(hi*(AMBM_ALPHA-AMBM_BETA) + (i+q)*AMBM_BETA);
+}
+
+void MagnitudeAlphaMaxBetaMin(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		magnitude[k] = uint16_t(AlphaMaxBetaMin(rawSamples+2*k));
+	}
+}
+
+void MagnitudeAlphaMaxBetaMin8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	for (uint32_t k = 0; k < pairs; k++) {
+		magnitude[k] = uint8_t(AlphaMaxBetaMin(rawSamples+2*k) >> 8);
+	}
+}
+
+/* --------------------------- Cortex-M7 SIMD32 --------------------------- */
+
+#if defined(MAGNITUDE_SIMD32)
+/* A word holds two pairs, I0 Q0 I1 Q1. UXTB16 splits it into [I0,I1] and
+ * [Q0,Q1] halfwords, SSUB16 removes the DC offset from both lanes at once,
+ * PKHBT/PKHTB regroup the lanes into [I0,Q0] and [I1,Q1] and SMUAD squares
+ * and sums each pair in one instruction. The sign is squared away, so the
+ * abs() and its branches disappear, and the result indexes the table of
+ * round(sqrt(n)*360), which is exact. */
+inline void Simd32Word(uint32_t word, uint32_t squared[2])
+{
+	const uint32_t offset = 0x007F007FU;
+	const uint32_t i = __SSUB16(__UXTB16(word), offset);
+	const uint32_t q = __SSUB16(__UXTB16(word >> 8), offset);
+	const uint32_t iq0 = __PKHBT(i, q, 16);
+	const uint32_t iq1 = __PKHTB(q, i, 16);
+
+	squared[0] = __SMUAD(iq0, iq0);
+	squared[1] = __SMUAD(iq1, iq1);
+}
+
+void MagnitudeSimd32(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 4 <= pairs; k += 4) {
+		uint32_t words[2];
+		uint32_t n[4];
+		memcpy(words, rawSamples+2*k, sizeof(words));
+		Simd32Word(words[0], n);
+		Simd32Word(words[1], n+2);
+		magnitude[k]   = magnitudeSquaredLUT.value[n[0]];
+		magnitude[k+1] = magnitudeSquaredLUT.value[n[1]];
+		magnitude[k+2] = magnitudeSquaredLUT.value[n[2]];
+		magnitude[k+3] = magnitudeSquaredLUT.value[n[3]];
+	}
+	MagnitudeLut(rawSamples+2*k, magnitude+k, pairs-k);
+}
+
+void MagnitudeSimd32_8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 4 <= pairs; k += 4) {
+		uint32_t words[2];
+		uint32_t n[4];
+		memcpy(words, rawSamples+2*k, sizeof(words));
+		Simd32Word(words[0], n);
+		Simd32Word(words[1], n+2);
+		magnitude[k]   = magnitudeSquaredLUT.value[n[0]] >> 8;
+		magnitude[k+1] = magnitudeSquaredLUT.value[n[1]] >> 8;
+		magnitude[k+2] = magnitudeSquaredLUT.value[n[2]] >> 8;
+		magnitude[k+3] = magnitudeSquaredLUT.value[n[3]] >> 8;
+	}
+	MagnitudeLut8(rawSamples+2*k, magnitude+k, pairs-k);
+}
+#endif
+
+/* ------------------------------- x86 SSE2 ------------------------------- */
+
+#if defined(MAGNITUDE_X86)
+/* 8 pairs per iteration. PMADDWD squares and sums each I/Q pair, the square
+ * root is taken in double precision, which rounds exactly like the table. */
+__attribute__((target("sse2")))
+inline __m128i Sse2Sqrt(__m128i n)
+{
+	const __m128d scale = _mm_set1_pd(MAGNITUDE_SCALE);
+	const __m128d lo = _mm_mul_pd(_mm_sqrt_pd(_mm_cvtepi32_pd(n)), scale);
+	const __m128d hi = _mm_mul_pd(_mm_sqrt_pd(_mm_cvtepi32_pd(_mm_srli_si128(n, 8))), scale);
+	return _mm_unpacklo_epi64(_mm_cvtpd_epi32(lo), _mm_cvtpd_epi32(hi));
+}
+
+__attribute__((target("sse2")))
+inline __m128i Sse2Magnitude8Pairs(const uint8_t* rawSamples)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i offset = _mm_set1_epi16(127);
+	const __m128i bias32 = _mm_set1_epi32(32768);
+	const __m128i bias16 = _mm_set1_epi16(-32768);
+
+	const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rawSamples));
+	const __m128i iqLo = _mm_sub_epi16(_mm_unpacklo_epi8(raw, zero), offset);
+	const __m128i iqHi = _mm_sub_epi16(_mm_unpackhi_epi8(raw, zero), offset);
+	const __m128i magLo = Sse2Sqrt(_mm_madd_epi16(iqLo, iqLo));
+	const __m128i magHi = Sse2Sqrt(_mm_madd_epi16(iqHi, iqHi));
+
+	/* SSE2 has only a signed 32->16 pack, so pack around 32768. */
+	return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(magLo, bias32),
+										 _mm_sub_epi32(magHi, bias32)), bias16);
+}
+
+__attribute__((target("sse2")))
+void MagnitudeSse2(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 8 <= pairs; k += 8) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(magnitude+k), Sse2Magnitude8Pairs(rawSamples+2*k));
+	}
+	MagnitudeLut(rawSamples+2*k, magnitude+k, pairs-k);
+}
+
+__attribute__((target("sse2")))
+void MagnitudeSse2_8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 16 <= pairs; k += 16) {
+		const __m128i lo = _mm_srli_epi16(Sse2Magnitude8Pairs(rawSamples+2*k), 8);
+		const __m128i hi = _mm_srli_epi16(Sse2Magnitude8Pairs(rawSamples+2*k+16), 8);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(magnitude+k), _mm_packus_epi16(lo, hi));
+	}
+	MagnitudeLut8(rawSamples+2*k, magnitude+k, pairs-k);
+}
+
+/* ------------------------------- x86 AVX2 ------------------------------- */
+
+/* 16 pairs per iteration. The single precision square root is off by one
+ * for a few inputs, so the rounded result r is corrected with exact 32 bit
+ * integer arithmetic: with N = n*360*360, r is right when
+ * r*r-r < N <= r*r+r (N > 0 for r > 0). Unsigned compares are done as signed
+ * compares on values biased by 2^31. */
+__attribute__((target("avx2")))
+inline __m256i Avx2Magnitude8Pairs(const uint8_t* rawSamples)
+{
+	const __m256i offset = _mm256_set1_epi16(127);
+	const __m256 scale = _mm256_set1_ps(MAGNITUDE_SCALE);
+	const __m256i scale2 = _mm256_set1_epi32(MAGNITUDE_SCALE*MAGNITUDE_SCALE);
+	const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+	const __m256i zero = _mm256_setzero_si256();
+
+	const __m256i iq = _mm256_sub_epi16(_mm256_cvtepu8_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(rawSamples))), offset);
+	const __m256i n = _mm256_madd_epi16(iq, iq);
+	__m256i r = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sqrt_ps(_mm256_cvtepi32_ps(n)), scale));
+
+	const __m256i squared = _mm256_xor_si256(_mm256_mullo_epi32(n, scale2), bias);
+	const __m256i rr = _mm256_mullo_epi32(r, r);
+	const __m256i upper = _mm256_xor_si256(_mm256_add_epi32(rr, r), bias);
+	const __m256i lower = _mm256_xor_si256(_mm256_sub_epi32(rr, r), bias);
+	const __m256i up = _mm256_cmpgt_epi32(squared, upper);
+	const __m256i down = _mm256_andnot_si256(_mm256_cmpgt_epi32(squared, lower),
+											 _mm256_cmpgt_epi32(r, zero));
+	r = _mm256_sub_epi32(r, up);
+	r = _mm256_add_epi32(r, down);
+	return r;
+}
+
+__attribute__((target("avx2")))
+inline __m256i Avx2Magnitude16Pairs(const uint8_t* rawSamples)
+{
+	const __m256i packed = _mm256_packus_epi32(Avx2Magnitude8Pairs(rawSamples),
+											   Avx2Magnitude8Pairs(rawSamples+16));
+	return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+__attribute__((target("avx2")))
+void MagnitudeAvx2(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 16 <= pairs; k += 16) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(magnitude+k), Avx2Magnitude16Pairs(rawSamples+2*k));
+	}
+	MagnitudeLut(rawSamples+2*k, magnitude+k, pairs-k);
+}
+
+__attribute__((target("avx2")))
+void MagnitudeAvx2_8(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs)
+{
+	uint32_t k = 0;
+	for (; k + 32 <= pairs; k += 32) {
+		const __m256i lo = _mm256_srli_epi16(Avx2Magnitude16Pairs(rawSamples+2*k), 8);
+		const __m256i hi = _mm256_srli_epi16(Avx2Magnitude16Pairs(rawSamples+2*k+32), 8);
+		const __m256i packed = _mm256_packus_epi16(lo, hi);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(magnitude+k),
+							_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	MagnitudeLut8(rawSamples+2*k, magnitude+k, pairs-k);
+}
+#endif
+
+const MagnitudeKernel kernels[MagnitudeKernelCount] =
+{
+	{ LutKernel, "lut", true, MagnitudeLut, MagnitudeLut8 },
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+	{ RawIQLutKernel, "rawiq", true, MagnitudeRawIQLut, MagnitudeRawIQLut8 },
+#else
+	{ RawIQLutKernel, "rawiq", true, NULL, NULL },
+#endif
+#if defined(MAGNITUDE_SIMD32)
+	{ Simd32Kernel, "simd32", true, MagnitudeSimd32, MagnitudeSimd32_8 },
+#else
+	{ Simd32Kernel, "simd32", true, NULL, NULL },
+#endif
+	{ AlphaMaxBetaMinKernel, "ambm", false, MagnitudeAlphaMaxBetaMin, MagnitudeAlphaMaxBetaMin8 },
+#if defined(MAGNITUDE_X86)
+	{ Sse2Kernel, "sse2", true, MagnitudeSse2, MagnitudeSse2_8 },
+	{ Avx2Kernel, "avx2", true, MagnitudeAvx2, MagnitudeAvx2_8 },
+#else
+	{ Sse2Kernel, "sse2", true, NULL, NULL },
+	{ Avx2Kernel, "avx2", true, NULL, NULL },
+#endif
+};
+
+bool IsSupported(MagnitudeKernelType type)
+{
+#if defined(MAGNITUDE_X86)
+	if (type == Sse2Kernel) {
+		return __builtin_cpu_supports("sse2");
+	}
+	if (type == Avx2Kernel) {
+		return __builtin_cpu_supports("avx2");
+	}
+#endif
+	return kernels[type].compute != NULL;
+}
+
+} // namespace
+
+const MagnitudeKernel* GetMagnitudeKernel(MagnitudeKernelType type)
+{
+	if (type >= MagnitudeKernelCount || IsSupported(type) == false) {
+		return NULL;
+	}
+	return &kernels[type];
+}
+
+const MagnitudeKernel* GetDefaultMagnitudeKernel()
+{
+	/* Fastest first, as measured with MagnitudeBenchmark. */
+	static const MagnitudeKernelType preference[] =
+	{
+		Avx2Kernel, Sse2Kernel, RawIQLutKernel, Simd32Kernel, LutKernel
+	};
+	for (MagnitudeKernelType type : preference) {
+		const MagnitudeKernel* kernel = GetMagnitudeKernel(type);
+		if (kernel != NULL) {
+			return kernel;
+		}
+	}
+	return &kernels[LutKernel];
+}
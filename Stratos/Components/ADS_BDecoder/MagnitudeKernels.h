@@ -0,0 +1,50 @@
+/*
+ * MagnitudeKernels.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_MAGNITUDEKERNELS_H_
+#define ADS_BDECODER_MAGNITUDEKERNELS_H_
+
+#include <cstdint>
+
+/* Interchangeable implementations of the I/Q -> magnitude stage.
+ *
+ * Every kernel converts `pairs` interleaved unsigned 8 bit I/Q pairs into
+ * magnitudes scaled like the reference table, round(sqrt(i*i+q*q)*360) with
+ * i and q taken relative to 127. Exact kernels reproduce the table bit for
+ * bit, approximate ones stay within a documented bound.
+ *
+ * The optional 8 bit output is the 16 bit magnitude >> 8 and halves the
+ * bandwidth of the magnitude buffer. */
+
+enum MagnitudeKernelType
+{
+	LutKernel = 0,              /* scalar, 129x129 table (reference) */
+	RawIQLutKernel,             /* scalar, 64K table indexed by the raw pair */
+	Simd32Kernel,               /* Cortex-M7 DSP, 4 pairs per iteration */
+	AlphaMaxBetaMinKernel,      /* no table, within 4.5% of the reference */
+	Sse2Kernel,                 /* x86 host build */
+	Avx2Kernel,                 /* x86 host build, runtime detected */
+	MagnitudeKernelCount
+};
+
+typedef void (*MagnitudeKernelFunc)(const uint8_t* rawSamples, uint16_t* magnitude, uint32_t pairs);
+typedef void (*Magnitude8KernelFunc)(const uint8_t* rawSamples, uint8_t* magnitude, uint32_t pairs);
+
+struct MagnitudeKernel
+{
+	MagnitudeKernelType type;
+	const char* name;
+	bool exact;
+	MagnitudeKernelFunc compute;
+	Magnitude8KernelFunc compute8;
+};
+
+/* NULL when the kernel is not compiled in or not supported by this CPU. */
+const MagnitudeKernel* GetMagnitudeKernel(MagnitudeKernelType type);
+/* Fastest exact kernel available. */
+const MagnitudeKernel* GetDefaultMagnitudeKernel();
+
+#endif /* ADS_BDECODER_MAGNITUDEKERNELS_H_ */
@@ -0,0 +1,126 @@
+/*
+ * MagnitudeLUT.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "MagnitudeLUT.h"
+
+/* Only the table the default kernel reads (GetDefaultMagnitudeKernel) goes
+ * to DTCM, the others stay in flash. On the board that is the SIMD32 kernel
+ * and its 64 KB squared magnitude table. */
+#define MAGNITUDE_LUT_SECTION
+#define MAGNITUDE_SQUARED_LUT_SECTION
+
+#if defined(MAGNITUDE_LUT_IN_DTCM)
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+#error "the 128 KB raw I/Q table does not fit in DTCM"
+#elif defined(STM32F767xx)
+#undef MAGNITUDE_SQUARED_LUT_SECTION
+#define MAGNITUDE_SQUARED_LUT_SECTION __attribute__((section(".dtcmram")))
+#else
+#undef MAGNITUDE_LUT_SECTION
+#define MAGNITUDE_LUT_SECTION __attribute__((section(".dtcmram")))
+#endif
+#endif
+
+namespace
+{
+
+/* Integer square root rounded to the nearest integer. Digit by digit
+ * method, after the loop x holds the remainder x - r*r, and sqrt(x) is
+ * closer to r+1 exactly when that remainder is larger than r. */
+constexpr uint32_t RoundedSqrt(uint32_t x)
+{
+	uint32_t r = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (x >= r + bit) {
+			x -= r + bit;
+			r = (r >> 1) + bit;
+		} else {
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (x > r) ? r + 1 : r;
+}
+
+constexpr MagnitudeLUT MakeMagnitudeLUT()
+{
+	MagnitudeLUT lut = {};
+	for (uint32_t i = 0; i < MAGNITUDE_LUT_SIDE; i++) {
+		for (uint32_t q = 0; q < MAGNITUDE_LUT_SIDE; q++) {
+			/* sqrt(n)*360 == sqrt(n*360*360), exact in 32 bits for n <= 2*128*128 */
+			lut.value[i*MAGNITUDE_LUT_SIDE+q] =
+				RoundedSqrt((i*i+q*q) * MAGNITUDE_SCALE * MAGNITUDE_SCALE);
+		}
+	}
+	return lut;
+}
+
+static_assert(RoundedSqrt(2U*128U*128U*MAGNITUDE_SCALE*MAGNITUDE_SCALE) <= UINT16_MAX,
+			  "magnitude does not fit in 16 bits");
+
+} // namespace
+
+MAGNITUDE_LUT_SECTION constexpr MagnitudeLUT magnitudeLUT = MakeMagnitudeLUT();
+
+static_assert(magnitudeLUT.value[1] == MAGNITUDE_SCALE, "bad magnitude table");
+static_assert(magnitudeLUT.value[MAGNITUDE_LUT_SIDE+1] == 509, "bad magnitude table");
+
+namespace
+{
+
+constexpr Magnitude8LUT MakeMagnitude8LUT()
+{
+	Magnitude8LUT lut = {};
+	for (uint32_t k = 0; k < MAGNITUDE_LUT_SIZE; k++) {
+		lut.value[k] = magnitudeLUT.value[k] >> 8;
+	}
+	return lut;
+}
+
+constexpr MagnitudeSquaredLUT MakeMagnitudeSquaredLUT()
+{
+	MagnitudeSquaredLUT lut = {};
+	for (uint32_t n = 0; n < MAGNITUDE_SQUARED_LUT_SIZE; n++) {
+		lut.value[n] = RoundedSqrt(n * MAGNITUDE_SCALE * MAGNITUDE_SCALE);
+	}
+	return lut;
+}
+
+} // namespace
+
+constexpr Magnitude8LUT magnitude8LUT = MakeMagnitude8LUT();
+MAGNITUDE_SQUARED_LUT_SECTION constexpr MagnitudeSquaredLUT magnitudeSquaredLUT = MakeMagnitudeSquaredLUT();
+
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+
+namespace
+{
+
+constexpr uint32_t AbsOffset(uint32_t raw)
+{
+	return (raw >= 127) ? raw - 127 : 127 - raw;
+}
+
+constexpr MagnitudeRawIQLUT MakeMagnitudeRawIQLUT()
+{
+	MagnitudeRawIQLUT lut = {};
+	for (uint32_t iq = 0; iq < MAGNITUDE_RAW_IQ_LUT_SIZE; iq++) {
+		lut.value[iq] = magnitudeLUT.value[AbsOffset(iq & 0xFF)*MAGNITUDE_LUT_SIDE +
+										   AbsOffset(iq >> 8)];
+	}
+	return lut;
+}
+
+} // namespace
+
+constexpr MagnitudeRawIQLUT magnitudeRawIQLUT = MakeMagnitudeRawIQLUT();
+
+#endif
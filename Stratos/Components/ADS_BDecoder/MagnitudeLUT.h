@@ -0,0 +1,66 @@
+/*
+ * MagnitudeLUT.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_MAGNITUDELUT_H_
+#define ADS_BDECODER_MAGNITUDELUT_H_
+
+#include <cstdint>
+
+/* Magnitude lookup tables, generated at compile time and kept in flash.
+ *
+ * Build options:
+ *  MAGNITUDE_LUT_IN_DTCM  - place the table the default kernel reads in
+ *                           DTCM RAM instead of flash (zero wait state,
+ *                           copied by the startup code, 64 KB of the 128 KB
+ *                           DTCM for the SIMD32 kernel on the board).
+ *  MAGNITUDE_RAW_IQ_LUT   - also generate a 64K entry table indexed directly
+ *                           by the raw I/Q byte pair, which removes the DC
+ *                           offset subtraction and abs() from the hot loop
+ *                           at the cost of 128 KB of flash. */
+
+/* |I| and |Q| after removing the 127 DC offset are in 0..128. */
+#define MAGNITUDE_LUT_SIDE 129
+#define MAGNITUDE_LUT_SIZE (MAGNITUDE_LUT_SIDE*MAGNITUDE_LUT_SIDE)
+#define MAGNITUDE_RAW_IQ_LUT_SIZE 65536
+/* i*i+q*q is in 0..2*128*128. */
+#define MAGNITUDE_SQUARED_LUT_SIZE (2*128*128+1)
+#define MAGNITUDE_SCALE 360
+
+/* value[i*129+q] = round(sqrt(i*i+q*q)*360) */
+struct MagnitudeLUT
+{
+	uint16_t value[MAGNITUDE_LUT_SIZE];
+};
+
+/* 8 bit variant, value[i*129+q] = round(sqrt(i*i+q*q)*360) >> 8 */
+struct Magnitude8LUT
+{
+	uint8_t value[MAGNITUDE_LUT_SIZE];
+};
+
+/* value[n] = round(sqrt(n)*360), indexed by the squared magnitude i*i+q*q
+ * for kernels that compute it with multiply-accumulate instructions. */
+struct MagnitudeSquaredLUT
+{
+	uint16_t value[MAGNITUDE_SQUARED_LUT_SIZE];
+};
+
+/* value[I | Q<<8] for the raw unsigned I and Q bytes, so a little endian
+ * 16 bit load of an I/Q pair is the index. */
+struct MagnitudeRawIQLUT
+{
+	uint16_t value[MAGNITUDE_RAW_IQ_LUT_SIZE];
+};
+
+extern const MagnitudeLUT magnitudeLUT;
+extern const Magnitude8LUT magnitude8LUT;
+extern const MagnitudeSquaredLUT magnitudeSquaredLUT;
+
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+extern const MagnitudeRawIQLUT magnitudeRawIQLUT;
+#endif
+
+#endif /* ADS_BDECODER_MAGNITUDELUT_H_ */
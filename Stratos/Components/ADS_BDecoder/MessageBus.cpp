@@ -0,0 +1,160 @@
+/*
+ * MessageBus.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "MessageBus.h"
+#include "CycleCounter.h"
+#include <cstring>
+
+MessageBus::MessageBus()
+{
+	head = 0;
+	count = 0;
+	policy = DropOldest;
+	pendingSignal = xSemaphoreCreateBinary();
+	ResetStats();
+}
+
+MessageBus::~MessageBus()
+{
+	vSemaphoreDelete(pendingSignal);
+}
+
+bool MessageBus::IsPosition(const ADS_BMessage& msg)
+{
+	return msg.msgtype == 17 && msg.CrcOk() && msg.IsAirbornePosition();
+}
+
+void MessageBus::Push(const ADS_BMessage& msg, uint32_t now)
+{
+	Slot& slot = slots[Index(count)];
+	slot.msg = msg;
+	slot.publishedAt = now;
+	count++;
+	if (count > stats.highWater) {
+		stats.highWater = count;
+	}
+}
+
+/* Removes the oldest pending message that is not a position, keeping the
+ * order of the others. At most MESSAGE_BUS_CAPACITY-1 slots move. */
+bool MessageBus::EvictOldestNonPosition()
+{
+	size_t n;
+	for (n = 0; n < count; n++) {
+		if (!IsPosition(slots[Index(n)].msg)) {
+			break;
+		}
+	}
+	if (n == count) {
+		return false;
+	}
+	for (; n + 1 < count; n++) {
+		slots[Index(n)] = slots[Index(n + 1)];
+	}
+	count--;
+	return true;
+}
+
+bool MessageBus::Publish(const ADS_BMessage& msg)
+{
+	uint32_t now = CycleCounterNow();
+	bool wasEmpty;
+
+	taskENTER_CRITICAL();
+	stats.published++;
+	if (count == MESSAGE_BUS_CAPACITY) {
+		if (policy == DropOldest) {
+			head = Index(1);
+			count--;
+			stats.droppedOldest++;
+			Push(msg, now);
+		} else if (policy == DropKeepPositions && IsPosition(msg) && EvictOldestNonPosition()) {
+			stats.droppedOldest++;
+			Push(msg, now);
+		} else {
+			stats.droppedNewest++;
+		}
+		taskEXIT_CRITICAL();
+		return false;
+	}
+	wasEmpty = (count == 0);
+	Push(msg, now);
+	taskEXIT_CRITICAL();
+
+	/* The consumer only needs waking for the first message of a batch. */
+	if (wasEmpty) {
+		xSemaphoreGive(pendingSignal);
+	}
+	return true;
+}
+
+size_t MessageBus::Drain(ADS_BMessage* out, size_t maxCount)
+{
+	uint32_t now = CycleCounterNow();
+	size_t n;
+
+	taskENTER_CRITICAL();
+	if (count && maxCount) {
+		uint32_t lag = now - slots[head].publishedAt;
+		stats.lagTicks = lag;
+		if (lag > stats.maxLagTicks) {
+			stats.maxLagTicks = lag;
+		}
+		stats.batches++;
+	}
+	for (n = 0; n < maxCount && count; n++) {
+		out[n] = slots[head].msg;
+		head = Index(1);
+		count--;
+	}
+	stats.delivered += n;
+	taskEXIT_CRITICAL();
+	return n;
+}
+
+bool MessageBus::Wait(TickType_t timeout)
+{
+	if (Pending()) {
+		return true;
+	}
+	xSemaphoreTake(pendingSignal, timeout);
+	return Pending() != 0;
+}
+
+size_t MessageBus::Pending() const
+{
+	size_t pending;
+	taskENTER_CRITICAL();
+	pending = count;
+	taskEXIT_CRITICAL();
+	return pending;
+}
+
+bool MessageBus::SetDropPolicy(MessageDropPolicy newPolicy)
+{
+	if (newPolicy >= MessageDropPolicyCount) {
+		return false;
+	}
+	policy = newPolicy;
+	return true;
+}
+
+MessageBusStats MessageBus::GetStats() const
+{
+	MessageBusStats copy;
+	taskENTER_CRITICAL();
+	copy = stats;
+	taskEXIT_CRITICAL();
+	return copy;
+}
+
+void MessageBus::ResetStats()
+{
+	taskENTER_CRITICAL();
+	memset(&stats, 0, sizeof(stats));
+	stats.highWater = count;
+	taskEXIT_CRITICAL();
+}
@@ -0,0 +1,96 @@
+/*
+ * MessageBus.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_MESSAGEBUS_H_
+#define ADS_BDECODER_MESSAGEBUS_H_
+
+#include "ADSBMessage.h"
+#include "cmsis_os.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Messages the bus holds before the drop policy kicks in. */
+#ifndef MESSAGE_BUS_CAPACITY
+#define MESSAGE_BUS_CAPACITY 32
+#endif
+
+/* Messages the consumer takes per Drain() in FlightControlerTask. */
+#define MESSAGE_BUS_BATCH 16
+
+/* What Publish() does when the bus is full. */
+enum MessageDropPolicy
+{
+	DropOldest = 0,         /* overwrite the oldest pending message */
+	DropNewest,             /* reject the incoming message */
+	DropKeepPositions,      /* evict the oldest non position message for a
+	                         * position, reject anything else */
+	MessageDropPolicyCount
+};
+
+struct MessageBusStats
+{
+	uint32_t published;     /* Messages offered by the producer. */
+	uint32_t delivered;     /* Messages handed to the consumer. */
+	uint32_t droppedNewest; /* Incoming messages rejected. */
+	uint32_t droppedOldest; /* Pending messages overwritten or evicted. */
+	uint32_t highWater;     /* Most messages pending at the same time. */
+	uint32_t batches;       /* Drain() calls that returned messages. */
+	uint32_t lagTicks;      /* Age of the oldest message at the last drain, */
+	uint32_t maxLagTicks;   /* in CycleCounter units. */
+};
+
+/* Hand over of decoded frames from RTLSDRDataAquisitionTask to
+ * FlightControlerTask. Publish() never blocks: when the consumer falls
+ * behind, messages are dropped according to the policy instead of stalling
+ * the demodulator. The consumer waits for the first pending message and
+ * then takes everything in batches. Both sides hold a critical section only
+ * for the copy of the records. */
+class MessageBus
+{
+public:
+	MessageBus();
+	~MessageBus();
+
+	/* Producer side, false when a message had to be dropped, either this
+	 * one or an older pending one. */
+	bool Publish(const ADS_BMessage& msg);
+
+	/* Consumer side: moves up to maxCount of the oldest pending messages
+	 * to out, returns how many. Never blocks. */
+	size_t Drain(ADS_BMessage* out, size_t maxCount);
+	/* Blocks up to timeout ticks until a message is pending. */
+	bool Wait(TickType_t timeout);
+	size_t Pending() const;
+
+	bool SetDropPolicy(MessageDropPolicy policy);
+	MessageDropPolicy GetDropPolicy() const { return policy; }
+
+	MessageBusStats GetStats() const;
+	void ResetStats();
+
+	static bool IsPosition(const ADS_BMessage& msg);
+
+private:
+	struct Slot
+	{
+		ADS_BMessage msg;
+		uint32_t publishedAt;   /* CycleCounterNow() at Publish(). */
+	};
+
+	void Push(const ADS_BMessage& msg, uint32_t now);
+	bool EvictOldestNonPosition();
+	size_t Index(size_t n) const { return (head + n) % MESSAGE_BUS_CAPACITY; }
+
+	std::array<Slot, MESSAGE_BUS_CAPACITY> slots;
+	size_t head;                /* Oldest pending message. */
+	size_t count;
+	MessageDropPolicy policy;
+	MessageBusStats stats;
+	SemaphoreHandle_t pendingSignal;
+};
+
+#endif /* ADS_BDECODER_MESSAGEBUS_H_ */
@@ -0,0 +1,286 @@
+/*
+ * ModeSCrc.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "ModeSCrc.h"
+#include <cstddef>
+
+#if defined(STM32F767xx)
+#include "stm32f7xx_hal.h"
+#define MODES_CRC_UNIT
+#elif defined(MODES_CRC_UNIT_EMULATION)
+#include "CrcUnitModel.h"
+#define MODES_CRC_UNIT
+#endif
+
+#define MODES_PARITY_BITS 24
+#define SHORT_SYNDROME_TABLE_SIZE 128
+#define LONG_SYNDROME_TABLE_SIZE 8192
+#define NO_BIT 0xFF
+
+namespace
+{
+
+/* Parity table. For each bit of a long frame, the CRC of a message with only
+ * that bit set. Short frames use the last 56 entries. The parity bits
+ * themselves do not feed the CRC, hence the trailing zeros. */
+constexpr uint32_t modes_checksum_table[MODES_LONG_MSG_BITS] = {
+0x3935ea, 0x1c9af5, 0xf1b77e, 0x78dbbf, 0xc397db, 0x9e31e9, 0xb0e2f0, 0x587178,
+0x2c38bc, 0x161c5e, 0x0b0e2f, 0xfa7d13, 0x82c48d, 0xbe9842, 0x5f4c21, 0xd05c14,
+0x682e0a, 0x341705, 0xe5f186, 0x72f8c3, 0xc68665, 0x9cb936, 0x4e5c9b, 0xd8d449,
+0x939020, 0x49c810, 0x24e408, 0x127204, 0x093902, 0x049c81, 0xfdb444, 0x7eda22,
+0x3f6d11, 0xe04c8c, 0x702646, 0x381323, 0xe3f395, 0x8e03ce, 0x4701e7, 0xdc7af7,
+0x91c77f, 0xb719bb, 0xa476d9, 0xadc168, 0x56e0b4, 0x2b705a, 0x15b82d, 0xf52612,
+0x7a9309, 0xc2b380, 0x6159c0, 0x30ace0, 0x185670, 0x0c2b38, 0x06159c, 0x030ace,
+0x018567, 0xff38b7, 0x80665f, 0xbfc92b, 0xa01e91, 0xaff54c, 0x57faa6, 0x2bfd53,
+0xea04ad, 0x8af852, 0x457c29, 0xdd4410, 0x6ea208, 0x375104, 0x1ba882, 0x0dd441,
+0xf91024, 0x7c8812, 0x3e4409, 0xe0d800, 0x706c00, 0x383600, 0x1c1b00, 0x0e0d80,
+0x0706c0, 0x038360, 0x01c1b0, 0x00e0d8, 0x00706c, 0x003836, 0x001c1b, 0xfff409,
+0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,
+0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,
+0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000
+};
+
+static_assert(modes_checksum_table[MODES_LONG_MSG_BITS - MODES_PARITY_BITS - 1] == MODES_CRC_POLY,
+			  "parity table does not match the generator polynomial");
+
+constexpr uint32_t CrcByte(uint32_t byte)
+{
+	uint32_t crc = byte << 16;
+	for (int k = 0; k < 8; k++) {
+		crc = (crc & 0x800000) ? (crc << 1) ^ MODES_CRC_POLY : crc << 1;
+	}
+	return crc & 0xFFFFFF;
+}
+
+constexpr CrcTable MakeCrcTable()
+{
+	CrcTable table = {};
+	for (uint32_t b = 0; b < 256; b++) {
+		table.value[b] = CrcByte(b);
+	}
+	return table;
+}
+
+} // namespace
+
+constexpr CrcTable modeSCrcTable = MakeCrcTable();
+
+static_assert(modeSCrcTable.value[1] == MODES_CRC_POLY, "bad CRC table");
+
+namespace
+{
+
+/* Syndrome caused by flipping bit j of a frame. Flipped data bits change the
+ * computed CRC, flipped parity bits the received one. */
+constexpr uint32_t BitSyndrome(int bits, int j)
+{
+	return (j < bits - MODES_PARITY_BITS) ?
+			modes_checksum_table[j + (MODES_LONG_MSG_BITS - bits)] :
+			1UL << (bits - 1 - j);
+}
+
+/* Open addressing (linear probing) map syndrome -> error bit positions.
+ * Syndrome 0 marks an empty slot, it never needs correcting. */
+template <uint32_t Size>
+struct SyndromeTable
+{
+	uint32_t syndrome[Size];
+	uint8_t bit[Size][2];       /* bit[1] is NO_BIT for single bit errors */
+	uint32_t ambiguous;         /* patterns sharing a syndrome, must be 0 */
+};
+
+constexpr uint32_t SyndromeHash(uint32_t syndrome, uint32_t size)
+{
+	return ((syndrome * 2654435761UL) >> 16) & (size - 1);
+}
+
+template <uint32_t Size>
+constexpr void InsertSyndrome(SyndromeTable<Size>& table, uint32_t syndrome, int bit0, int bit1)
+{
+	uint32_t slot = SyndromeHash(syndrome, Size);
+	while (table.syndrome[slot] != 0) {
+		if (table.syndrome[slot] == syndrome) {
+			table.ambiguous++;
+			return;
+		}
+		slot = (slot + 1) & (Size - 1);
+	}
+	table.syndrome[slot] = syndrome;
+	table.bit[slot][0] = uint8_t(bit0);
+	table.bit[slot][1] = uint8_t(bit1);
+}
+
+template <uint32_t Size>
+constexpr SyndromeTable<Size> MakeSyndromeTable(int bits, int maxErrors)
+{
+	SyndromeTable<Size> table = {};
+	for (int i = 0; i < bits; i++) {
+		InsertSyndrome(table, BitSyndrome(bits, i), i, NO_BIT);
+	}
+	if (maxErrors == 2) {
+		for (int i = 0; i < bits; i++) {
+			for (int j = i + 1; j < bits; j++) {
+				InsertSyndrome(table, BitSyndrome(bits, i) ^ BitSyndrome(bits, j), i, j);
+			}
+		}
+	}
+	return table;
+}
+
+constexpr SyndromeTable<SHORT_SYNDROME_TABLE_SIZE> shortSyndromes =
+		MakeSyndromeTable<SHORT_SYNDROME_TABLE_SIZE>(MODES_SHORT_MSG_BITS, 1);
+constexpr SyndromeTable<LONG_SYNDROME_TABLE_SIZE> longSyndromes =
+		MakeSyndromeTable<LONG_SYNDROME_TABLE_SIZE>(MODES_LONG_MSG_BITS, 2);
+
+static_assert(shortSyndromes.ambiguous == 0, "1 bit errors in 56 bit frames are not unique");
+static_assert(longSyndromes.ambiguous == 0, "1 and 2 bit errors in 112 bit frames are not unique");
+
+template <uint32_t Size>
+const uint8_t* FindSyndrome(const SyndromeTable<Size>& table, uint32_t syndrome)
+{
+	uint32_t slot = SyndromeHash(syndrome, Size);
+	while (table.syndrome[slot] != 0) {
+		if (table.syndrome[slot] == syndrome) {
+			return table.bit[slot];
+		}
+		slot = (slot + 1) & (Size - 1);
+	}
+	return NULL;
+}
+
+#if defined(MODES_CRC_UNIT)
+/* The CRC unit only takes odd 7, 8, 16 or 32 bit polynomials, so it is
+ * programmed with P = G*(x^8+1), of degree 32. Since G divides P, reducing
+ * the unit's result mod G gives the Mode S CRC: with M = Mhi*x^8 + b,
+ * M*x^24 mod G = (Mhi*x^32 mod P + b*x^24) mod G. The unit computes
+ * Mhi*x^32 mod P from all data bytes but the last, and one byte table
+ * step adds b and does the final reduction. */
+#define MODES_CRC_UNIT_POLY 0xFE0BFD09UL    /* ((G << 8) ^ G), x^32 implicit */
+
+#if defined(STM32F767xx)
+inline void CrcUnitConfigure(uint32_t poly)
+{
+	__HAL_RCC_CRC_CLK_ENABLE();
+	CRC->POL = poly;
+	CRC->INIT = 0U;
+	CRC->CR = CRC_POLYLENGTH_32B;   /* no bit reversal */
+}
+
+inline void CrcUnitReset()
+{
+	CRC->CR |= CRC_CR_RESET;
+}
+
+inline void CrcUnitWrite(uint8_t byte)
+{
+	*reinterpret_cast<volatile uint8_t*>(&CRC->DR) = byte;
+}
+
+inline uint32_t CrcUnitRead()
+{
+	return CRC->DR;
+}
+#endif
+
+uint32_t ModeSCrcHardware(const uint8_t* msg, int bits)
+{
+	const int dataBytes = bits/8 - MODES_PARITY_BITS/8;
+
+	CrcUnitReset();
+	for (int k = 0; k < dataBytes - 1; k++) {
+		CrcUnitWrite(msg[k]);
+	}
+	const uint32_t crc = CrcUnitRead() ^ (uint32_t(msg[dataBytes - 1]) << 24);
+	return (crc & 0xFFFFFF) ^ modeSCrcTable.value[crc >> 24];
+}
+
+bool ConfigureCrcUnit()
+{
+	CrcUnitConfigure(MODES_CRC_UNIT_POLY);
+	return true;
+}
+#endif
+
+const CrcEngine engines[CrcEngineCount] =
+{
+	{ CrcReferenceEngine, "reference", ModeSCrcReference },
+	{ CrcTableEngine, "table", ModeSCrcTable },
+#if defined(MODES_CRC_UNIT)
+	{ CrcHardwareEngine, "hardware", ModeSCrcHardware },
+#else
+	{ CrcHardwareEngine, "hardware", NULL },
+#endif
+};
+
+} // namespace
+
+const CrcEngine* GetCrcEngine(CrcEngineType type)
+{
+	if (type >= CrcEngineCount || engines[type].checksum == NULL) {
+		return NULL;
+	}
+#if defined(MODES_CRC_UNIT)
+	/* The unit is not shared, configure it on first use. */
+	if (type == CrcHardwareEngine) {
+		static bool configured = ConfigureCrcUnit();
+		(void)configured;
+	}
+#endif
+	return &engines[type];
+}
+
+uint32_t ModeSCrcTable(const uint8_t* msg, int bits)
+{
+	const int dataBytes = bits/8 - MODES_PARITY_BITS/8;
+	uint32_t crc = 0;
+
+	for (int k = 0; k < dataBytes; k++) {
+		crc = ModeSCrcUpdate(crc, msg[k]);
+	}
+	return crc;
+}
+
+uint32_t ModeSCrcReference(const uint8_t* msg, int bits)
+{
+    uint32_t crc = 0;
+    int offset = (bits == 112) ? 0 : (112-56);
+    int j;
+
+    for(j = 0; j < bits; j++) {
+        int byte = j/8;
+        int bit = j%8;
+        int bitmask = 1 << (7-bit);
+
+        /* If bit is set, xor with corresponding table entry. */
+        if (msg[byte] & bitmask)
+            crc ^= modes_checksum_table[j+offset];
+    }
+    return crc; /* 24 bit checksum. */
+}
+
+int ModeSFixErrors(uint8_t* msg, int bits, uint32_t syndrome, int maxErrors, int errorBits[2])
+{
+	if (syndrome == 0 || maxErrors <= 0) {
+		return 0;
+	}
+
+	const uint8_t* bit = (bits == MODES_LONG_MSG_BITS) ?
+			FindSyndrome(longSyndromes, syndrome) :
+			FindSyndrome(shortSyndromes, syndrome);
+	if (bit == NULL) {
+		return 0;
+	}
+
+	const int count = (bit[1] == NO_BIT) ? 1 : 2;
+	if (count > maxErrors) {
+		return 0;
+	}
+	for (int k = 0; k < count; k++) {
+		msg[bit[k] / 8] ^= uint8_t(1 << (7 - bit[k] % 8));
+		errorBits[k] = bit[k];
+	}
+	return count;
+}
@@ -0,0 +1,72 @@
+/*
+ * ModeSCrc.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_MODESCRC_H_
+#define ADS_BDECODER_MODESCRC_H_
+
+#include "ADSBMessage.h"
+#include <cstdint>
+
+/* How far DecodeMessage goes repairing frames with a bad CRC. */
+enum CrcCorrection
+{
+	CrcCorrectionOff = 0,       /* only report the bad CRC */
+	CrcCorrectionSingleBit,     /* fix 1 bit errors in DF17 */
+	CrcCorrectionTwoBits        /* also fix 2 bit errors in DF17 */
+};
+
+#define MODES_CRC_POLY 0xFFF409   /* x^24 + ... + 1, x^24 implicit */
+
+/* Interchangeable implementations of the Mode S parity, the CRC of the
+ * first bits-24 bits of a frame. All of them return the same 24 bit value. */
+enum CrcEngineType
+{
+	CrcReferenceEngine = 0,     /* bit serial, one table XOR per set bit */
+	CrcTableEngine,             /* byte wise, also usable incrementally */
+	CrcHardwareEngine,          /* STM32 CRC unit */
+	CrcEngineCount
+};
+
+typedef uint32_t (*CrcEngineFunc)(const uint8_t* msg, int bits);
+
+struct CrcEngine
+{
+	CrcEngineType type;
+	const char* name;
+	CrcEngineFunc checksum;
+};
+
+/* NULL when the engine is not available in this build. */
+const CrcEngine* GetCrcEngine(CrcEngineType type);
+
+uint32_t ModeSCrcReference(const uint8_t* msg, int bits);
+uint32_t ModeSCrcTable(const uint8_t* msg, int bits);
+
+/* value[b] = b(x)*x^24 mod G(x) */
+struct CrcTable
+{
+	uint32_t value[256];
+};
+
+extern const CrcTable modeSCrcTable;
+
+/* Feeds one data byte into a running CRC, starting from 0. After the
+ * bits/8-3 data bytes of a frame the result equals ModeSCrcTable(). */
+inline uint32_t ModeSCrcUpdate(uint32_t crc, uint8_t byte)
+{
+	return ((crc << 8) ^ modeSCrcTable.value[((crc >> 16) ^ byte) & 0xFF]) & 0xFFFFFF;
+}
+
+/* Repairs msg using its syndrome, the received parity field xor the
+ * computed CRC. The syndrome is looked up in compile time hash tables of
+ * every 1 bit (56 and 112 bit frames) and 2 bit (112 bit frames) error
+ * pattern, so the cost does not depend on the frame length.
+ *
+ * Returns the number of bits flipped (1 or 2) and their positions in
+ * errorBits, or 0 if no pattern of at most maxErrors bits matches. */
+int ModeSFixErrors(uint8_t* msg, int bits, uint32_t syndrome, int maxErrors, int errorBits[2]);
+
+#endif /* ADS_BDECODER_MODESCRC_H_ */
@@ -0,0 +1,80 @@
+/*
+ * MultiPhaseDemod.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "MultiPhaseDemod.h"
+#include <cstddef>
+
+namespace
+{
+
+/* Fifths of sample s inside the window [begin, end), both in fifths. */
+constexpr int Overlap(int s, int begin, int end)
+{
+	int lo = (5*s > begin) ? 5*s : begin;
+	int hi = (5*s+5 < end) ? 5*s+5 : end;
+	return (hi > lo) ? hi - lo : 0;
+}
+
+constexpr DemodTable MakeDemodTable(uint32_t sampleRate, uint32_t halfBitFifths)
+{
+	DemodTable table = {};
+	const int h = halfBitFifths;
+
+	table.sampleRate = sampleRate;
+	table.halfBitFifths = halfBitFifths;
+	for (int phase = 0; phase < MODES_DEMOD_PHASES; phase++) {
+		for (int k = 0; k < MODES_PREAMBLE_HALF_BITS; k++) {
+			DemodWindow& w = table.preamble[phase][k];
+			const int begin = phase + k*h;
+			w.offset = begin/5;
+			for (int t = 0; t < 2; t++) {
+				w.weight[t] = Overlap(w.offset+t, begin, begin+h);
+			}
+		}
+		for (int k = 0; k < MODES_LONG_MSG_BITS; k++) {
+			DemodBit& b = table.bit[phase][k];
+			const int begin = phase + (MODES_PREAMBLE_HALF_BITS + 2*k)*h;
+			b.offset = begin/5;
+			for (int t = 0; t < MODES_DEMOD_TAPS; t++) {
+				b.weight[t] = Overlap(b.offset+t, begin, begin+h) -
+							  Overlap(b.offset+t, begin+h, begin+2*h);
+			}
+		}
+	}
+	return table;
+}
+
+} // namespace
+
+constexpr DemodTable demodTable2000 = MakeDemodTable(MODES_SAMPLING_2000K, 5);
+constexpr DemodTable demodTable2400 = MakeDemodTable(MODES_SAMPLING_2400K, 6);
+
+/* At 2 MS/s and phase 0 a half bit is exactly one sample. */
+static_assert(demodTable2000.preamble[0][9].offset == 9 &&
+			  demodTable2000.preamble[0][9].weight[0] == 5 &&
+			  demodTable2000.preamble[0][9].weight[1] == 0, "bad demodulator table");
+static_assert(demodTable2000.bit[0][0].offset == 16 &&
+			  demodTable2000.bit[0][0].weight[0] == 5 &&
+			  demodTable2000.bit[0][0].weight[1] == -5, "bad demodulator table");
+/* At 2.4 MS/s the last bit starts at (16+222)*6+4 fifths = sample 286.4. */
+static_assert(demodTable2400.bit[4][MODES_LONG_MSG_BITS-1].offset == 286 &&
+			  demodTable2400.bit[4][MODES_LONG_MSG_BITS-1].weight[0] == 3 &&
+			  demodTable2400.bit[4][MODES_LONG_MSG_BITS-1].weight[1] == 1 &&
+			  demodTable2400.bit[4][MODES_LONG_MSG_BITS-1].weight[2] == -4 &&
+			  demodTable2400.bit[4][MODES_LONG_MSG_BITS-1].weight[3] == 0, "bad demodulator table");
+static_assert(DemodReach(6) == 290, "bad demodulator reach");
+
+const DemodTable* GetDemodTable(uint32_t sampleRate)
+{
+	switch (sampleRate) {
+	case MODES_SAMPLING_2000K:
+		return &demodTable2000;
+	case MODES_SAMPLING_2400K:
+		return &demodTable2400;
+	default:
+		return NULL;
+	}
+}
@@ -0,0 +1,133 @@
+/*
+ * MultiPhaseDemod.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_MULTIPHASEDEMOD_H_
+#define ADS_BDECODER_MULTIPHASEDEMOD_H_
+
+#include "ADSBMessage.h"
+#include <cstdint>
+
+/* Tables for the multi-phase demodulator, generated at compile time.
+ *
+ * Positions are counted in fifths of a sample, which keeps both supported
+ * sample rates integral: half a bit (0.5 us) is 5 fifths at 2 MS/s and 6
+ * fifths at 2.4 MS/s. A frame may start on any fifth, its sub-sample phase
+ * (0..4) selects the table row. Integrating the magnitude over a half bit
+ * window is then a weighted sum of at most two samples, and the correlation
+ * of a whole bit (first half minus second half) one of at most four. */
+
+#define MODES_SAMPLING_2000K 2000000U
+#define MODES_SAMPLING_2400K 2400000U
+
+#define MODES_DEMOD_PHASES 5         /* Sub-sample phases, one per fifth. */
+#define MODES_DEMOD_TAPS 4           /* Samples touched by one bit. */
+#define MODES_PREAMBLE_HALF_BITS 16  /* 8 us of preamble. */
+
+/* Magnitude integrated over one half bit of the preamble. */
+struct DemodWindow
+{
+	uint16_t offset;                 /* First sample, from the frame start sample. */
+	uint8_t weight[2];               /* Fifths of each sample inside the window. */
+};
+
+/* Correlation of one data bit: positive for a 1 (pulse in the first half). */
+struct DemodBit
+{
+	uint16_t offset;
+	int8_t weight[MODES_DEMOD_TAPS];
+};
+
+struct DemodTable
+{
+	uint32_t sampleRate;
+	uint32_t halfBitFifths;
+	DemodWindow preamble[MODES_DEMOD_PHASES][MODES_PREAMBLE_HALF_BITS];
+	DemodBit bit[MODES_DEMOD_PHASES][MODES_LONG_MSG_BITS];
+};
+
+extern const DemodTable demodTable2000;
+extern const DemodTable demodTable2400;
+
+/* Table for a sample rate, NULL when the rate is not supported. */
+const DemodTable* GetDemodTable(uint32_t sampleRate);
+
+/* Samples a long frame reads from its start sample, whatever its phase. */
+constexpr uint32_t DemodReach(uint32_t halfBitFifths)
+{
+	return (MODES_DEMOD_PHASES-1 +
+			(MODES_PREAMBLE_HALF_BITS + 2*(MODES_LONG_MSG_BITS-1))*halfBitFifths)/5 +
+		   MODES_DEMOD_TAPS;
+}
+
+/* Reach at the highest supported rate, 2.4 MS/s. */
+#define MODES_DEMOD_MAX_REACH DemodReach(6)
+
+/* Whole samples covered by a frame of the given length. */
+inline uint32_t DemodFrameSamples(const DemodTable& table, uint32_t bits)
+{
+	return ((MODES_PREAMBLE_HALF_BITS + 2*bits) * table.halfBitFifths) / 5;
+}
+
+inline int DemodWindowEnergy(const uint16_t* m, const DemodWindow& w)
+{
+	return w.weight[0]*m[w.offset] + w.weight[1]*m[w.offset+1];
+}
+
+inline int DemodBitCorrelation(const uint16_t* m, const DemodBit& b)
+{
+	const uint16_t* s = m + b.offset;
+	return b.weight[0]*s[0] + b.weight[1]*s[1] + b.weight[2]*s[2] + b.weight[3]*s[3];
+}
+
+/* Magnitude integrated over [begin, end), in fifths from m[0]. */
+inline int DemodSpanEnergy(const uint16_t* m, uint32_t begin, uint32_t end)
+{
+	uint32_t first = begin/5;
+	uint32_t last = (end-1)/5;
+	if (first == last) return (end-begin)*m[first];
+
+	int energy = (5*(first+1)-begin)*m[first] + (end-5*last)*m[last];
+	for (uint32_t s = first+1; s < last; s++) energy += 5*m[s];
+	return energy;
+}
+
+/* The preamble relations of the classic 2 MS/s check, evaluated on half
+ * bit windows at the given phase for a frame starting in m[0]. Returns the
+ * summed energy of the four pulses, 0 when the check fails. At 2 MS/s and
+ * phase 0 every window is a single sample and this is the classic check. */
+inline int DemodCheckPreamble(const uint16_t* m, const DemodTable& table, uint32_t phase)
+{
+	const DemodWindow* w = table.preamble[phase];
+
+	/* Cheapest relations first, most positions fail within two windows. */
+	int e0 = DemodWindowEnergy(m, w[0]);
+	int e1 = DemodWindowEnergy(m, w[1]);
+	if (!(e0 > e1)) return 0;
+	int e2 = DemodWindowEnergy(m, w[2]);
+	if (!(e1 < e2)) return 0;
+	int e3 = DemodWindowEnergy(m, w[3]);
+	if (!(e2 > e3 && e3 < e0)) return 0;
+	int e4 = DemodWindowEnergy(m, w[4]);
+	int e5 = DemodWindowEnergy(m, w[5]);
+	int e6 = DemodWindowEnergy(m, w[6]);
+	if (!(e4 < e0 && e5 < e0 && e6 < e0)) return 0;
+	int e7 = DemodWindowEnergy(m, w[7]);
+	int e8 = DemodWindowEnergy(m, w[8]);
+	int e9 = DemodWindowEnergy(m, w[9]);
+	if (!(e7 > e8 && e8 < e9 && e9 > e6)) return 0;
+
+	/* Gaps between and after the pulses must stay below the average pulse
+	 * level, windows next to a pulse are left out as above. */
+	int pulses = e0+e2+e7+e9;
+	int high = pulses/6;
+	if (e4 >= high || e5 >= high) return 0;
+	for (int k = 11; k <= 14; k++) {
+		if (DemodWindowEnergy(m, w[k]) >= high) return 0;
+	}
+	return pulses;
+}
+
+#endif /* ADS_BDECODER_MULTIPHASEDEMOD_H_ */
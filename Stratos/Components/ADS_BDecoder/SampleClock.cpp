@@ -0,0 +1,130 @@
+/*
+ * SampleClock.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "SampleClock.h"
+#include "CycleCounter.h"
+#include <cstring>
+
+SampleClock::SampleClock()
+{
+	next = 0;
+	sampleRate = ADS_B_SAMPLING;
+	epoch = 0;
+	anchored = false;
+	anchorSample = 0;
+	anchorCycles = 0;
+	anchorTick = 0;
+	ResetStats();
+}
+
+void SampleClock::SetSampleRate(uint32_t rate)
+{
+	taskENTER_CRITICAL();
+	sampleRate = rate;
+	taskEXIT_CRITICAL();
+}
+
+uint64_t SampleClock::Advance(uint32_t samples)
+{
+	uint64_t start = next;
+	next += samples;
+	stats.buffers++;
+	return start;
+}
+
+/* The cycle counter resolves a sample but wraps within seconds, past half
+ * a wrap the tick is used instead. */
+uint64_t SampleClock::SamplesElapsed(uint32_t cycles, uint32_t ticks, uint32_t rate)
+{
+	const uint32_t frequency = CycleCounterFrequency();
+	const uint64_t wrapTicks = ((uint64_t)1 << 32) * configTICK_RATE_HZ / frequency;
+
+	if (ticks < wrapTicks / 2) {
+		return ((uint64_t)cycles * rate + frequency / 2) / frequency;
+	}
+	return ((uint64_t)ticks * rate + configTICK_RATE_HZ / 2) / configTICK_RATE_HZ;
+}
+
+uint64_t SampleClock::Advance(uint32_t samples, const SampleBufferTime& time)
+{
+	if (time.afterGap) {
+		if (anchored) {
+			uint64_t elapsed = SamplesElapsed(time.cycles - anchorCycles, time.tick - anchorTick, sampleRate);
+			if (elapsed > samples) {
+				next += elapsed - samples;
+				stats.samplesLost += elapsed - samples;
+			}
+		}
+		epoch++;
+		stats.gaps++;
+	}
+	uint64_t start = Advance(samples);
+
+	taskENTER_CRITICAL();
+	anchored = true;
+	anchorSample = next;
+	anchorCycles = time.cycles;
+	anchorTick = time.tick;
+	taskEXIT_CRITICAL();
+	return start;
+}
+
+uint64_t SampleClock::Now() const
+{
+	uint64_t sample;
+	uint32_t cycles;
+	TickType_t tick;
+	uint32_t rate;
+	bool haveAnchor;
+
+	taskENTER_CRITICAL();
+	haveAnchor = anchored;
+	sample = haveAnchor ? anchorSample : next;
+	cycles = anchorCycles;
+	tick = anchorTick;
+	rate = sampleRate;
+	taskEXIT_CRITICAL();
+
+	if (!haveAnchor) {
+		return sample;
+	}
+	return sample + SamplesElapsed(CycleCounterNow() - cycles, xTaskGetTickCount() - tick, rate);
+}
+
+uint32_t SampleClock::AgeMs(uint64_t timestamp) const
+{
+	uint64_t now = Now();
+	if (timestamp >= now) {
+		return 0;
+	}
+	return (uint32_t)((now - timestamp) * 1000U / sampleRate);
+}
+
+TickType_t SampleClock::ToTick(uint64_t timestamp) const
+{
+	uint64_t sample;
+	TickType_t tick;
+
+	taskENTER_CRITICAL();
+	sample = anchorSample;
+	tick = anchorTick;
+	taskEXIT_CRITICAL();
+
+	if (timestamp >= sample) {
+		return tick + (TickType_t)((timestamp - sample) * configTICK_RATE_HZ / sampleRate);
+	}
+	return tick - (TickType_t)((sample - timestamp) * configTICK_RATE_HZ / sampleRate);
+}
+
+SampleClockStats SampleClock::GetStats() const
+{
+	return stats;
+}
+
+void SampleClock::ResetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
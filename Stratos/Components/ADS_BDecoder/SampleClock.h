@@ -0,0 +1,83 @@
+/*
+ * SampleClock.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ADS_BDECODER_SAMPLECLOCK_H_
+#define ADS_BDECODER_SAMPLECLOCK_H_
+
+#include "RTLSDRConfig.h"
+#include "cmsis_os.h"
+#include <cstdint>
+
+struct SampleClockStats
+{
+	uint32_t buffers;       /* Buffers counted. */
+	uint32_t gaps;          /* Buffers that followed lost samples. */
+	uint64_t samplesLost;   /* Samples skipped over the gaps (estimated). */
+};
+
+/* Running count of the samples received from the dongle, the time base of
+ * the ADS_BMessage timestamps, correlated with the FreeRTOS tick and the
+ * cycle counter.
+ *
+ * Every buffer advances the clock by its samples. A buffer stamped with its
+ * capture time also moves the anchor: the sample count, cycle counter and
+ * tick at its last sample, which turn timestamps into ages and ticks. When
+ * samples were lost the clock skips as many samples as the capture times
+ * say went by, so timestamps stay on one time line, and starts a new epoch:
+ * timestamps of the same epoch are sample exact relative to each other,
+ * across epochs only as exact as the estimate.
+ *
+ * Advance() belongs to the acquisition task, the conversions may be called
+ * from any task. */
+class SampleClock
+{
+public:
+	SampleClock();
+
+	void SetSampleRate(uint32_t rate);
+	uint32_t GetSampleRate() const { return sampleRate; }
+
+	/* Counts a buffer of contiguous samples and returns the timestamp of
+	 * its first sample. */
+	uint64_t Advance(uint32_t samples);
+	/* Same for a buffer stamped by the driver, skipping the lost samples
+	 * when time.afterGap is set. */
+	uint64_t Advance(uint32_t samples, const SampleBufferTime& time);
+	/* Timestamp the next buffer will start at, without a gap. */
+	uint64_t GetNext() const { return next; }
+	uint8_t GetEpoch() const { return epoch; }
+
+	/* Present time on the sample clock, from the anchor and the cycle
+	 * counter, or the tick once the anchor is too old for the cycle counter
+	 * (no buffers for a while). Without an anchor (replay) the end of the
+	 * last buffer. */
+	uint64_t Now() const;
+	/* Milliseconds since the given timestamp, 0 for future ones. */
+	uint32_t AgeMs(uint64_t timestamp) const;
+	/* FreeRTOS tick at the given timestamp, the tick of the last anchor
+	 * (or 0) extrapolated at the nominal sample rate. */
+	TickType_t ToTick(uint64_t timestamp) const;
+
+	SampleClockStats GetStats() const;
+	void ResetStats();
+
+private:
+	/* Samples that went by in the given cycle counter and tick deltas. */
+	static uint64_t SamplesElapsed(uint32_t cycles, uint32_t ticks, uint32_t rate);
+
+	uint64_t next;
+	uint32_t sampleRate;
+	uint8_t epoch;
+	SampleClockStats stats;
+
+	/* Written by Advance, read by the conversions in a critical section. */
+	bool anchored;
+	uint64_t anchorSample;      /* Timestamp one past the buffer's last sample. */
+	uint32_t anchorCycles;
+	TickType_t anchorTick;
+};
+
+#endif /* ADS_BDECODER_SAMPLECLOCK_H_ */
@@ -9,12 +9,20 @@
 #include "USBDriver.h"
 
 #include "convenience.h"
+#include "libusb_port.h"
 #include "rtl-sdr.h"
 #include "BoardMenager.h"
+#include "CycleCounter.h"
 
 RTLSDR::RTLSDR(USBDriver* usbDriverhandle) : usbDriverHandle(usbDriverhandle)
 {
 	deviceReady = false;
+	transferBuffer = NULL;
+	captureStalled = false;
+	buffersCaptured = 0;
+	overruns = 0;
+	captureStartTick = 0;
+	sampleRate = 0;
 }
 
 volatile bool RTLSDR::IsDeviceReady() const
@@ -45,40 +53,100 @@ uint8_t RTLSDR::OpenDevice(int32_t  tunerPpmError,
 
     // Set the sample rate
     verbose_set_sample_rate(dev, adcSampRate);
+    sampleRate = adcSampRate;
 
     // Reset endpoint before we start reading from it (mandatory)
     verbose_reset_buffer(dev);
 
     // begin capture radio data
     deviceReady = true;
-    GetNewRawSamples();
+    StartCapture();
     return 0;
 }
 
+void RTLSDR::StartCapture()
+{
+	buffersCaptured = 0;
+	overruns = 0;
+	captureStalled = false;
+	captureStartTick = xTaskGetTickCount();
+	SubmitTransfer(true);
+}
+
+/* Reads into the buffer at the head of the ring, which is only committed
+ * once the URB is done. Runs in interrupt context when the URB completion
+ * callback resubmits, so it must not call task level FreeRTOS or libusb
+ * APIs. */
+void RTLSDR::SubmitTransfer(bool afterGap)
+{
+	SpscRing<RawSampleBuffer,USB_BUFFER_COUNT>::Span span = sampleRing.AcquireWrite();
+	if(span.count == 0)
+	{
+		overruns++;
+		transferBuffer = NULL;
+		captureStalled = true;
+		return;
+	}
+	transferBuffer = span.data;
+	transferBuffer->time.afterGap = afterGap;
+	libusb_port_submit_in(USB_PIPE_NUMBER, transferBuffer->samples.data(), USB_IN_STREAM_SIZE);
+}
 
+/* Stamped first thing, the completion is the end of the buffer. */
 void RTLSDR::NotifyNewRawSampleRecived()
 {
-	GetNewRawSamples();
+	RawSampleBuffer* buffer = transferBuffer;
+	if(buffer == NULL)
+	{
+		return;
+	}
+	buffer->time.cycles = CycleCounterNow();
+	buffer->time.tick = xTaskGetTickCountFromISR();
+	sampleRing.CommitWrite(1);
+	buffersCaptured++;
+	SubmitTransfer(false);
 }
 
-void RTLSDR::NotifyRawSampleProcessed()
+const RawSampleBuffer* RTLSDR::GetRawSamplesFromBuffer()
 {
-	GetNewRawSamples();
+	SpscRing<RawSampleBuffer,USB_BUFFER_COUNT>::Span span = sampleRing.AcquireRead();
+	return (span.count > 0) ? span.data : NULL;
 }
 
-uint8_t* RTLSDR::GetRawSamplesFromBuffer()
+/* With capture stalled no URB is outstanding and the interrupt does not
+ * touch the ring, so the task can take over the producer side to restart
+ * it. The buffers still queued were filled before the pause, the gap is in
+ * front of the next one captured. */
+void RTLSDR::NotifyRawSampleProcessed()
 {
-	return buff;
+	sampleRing.ReleaseRead(1);
+	if(captureStalled == true)
+	{
+		captureStalled = false;
+		SubmitTransfer(true);
+	}
 }
-/*
-std::array<uint8_t,USB_IN_STREAM_SIZE>& RTLSDR::GetRawSamplesFromBuffer()
+
+RTLSDRCaptureStats RTLSDR::GetCaptureStats() const
 {
-	return rawSamplesBuffer.GetTailElement();
+	RTLSDRCaptureStats stats;
+	stats.buffers = buffersCaptured;
+	stats.overruns = overruns;
+	stats.startTick = captureStartTick;
+	stats.sampleRate = sampleRate;
+	return stats;
 }
-*/
-void RTLSDR::GetNewRawSamples()
+
+float RTLSDR::GetCaptureDutyCycle() const
 {
-	rtlsdr_read_sync(dev, buff,2048,0);
+	TickType_t wallTicks = xTaskGetTickCount() - captureStartTick;
+	if(wallTicks == 0 || sampleRate == 0)
+	{
+		return 0.0F;
+	}
+	float sampled = float(buffersCaptured) * (USB_IN_STREAM_SIZE / 2) / sampleRate;
+	float wall = float(wallTicks) / configTICK_RATE_HZ;
+	return sampled / wall;
 }
 
 
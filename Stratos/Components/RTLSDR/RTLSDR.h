@@ -11,7 +11,10 @@
 
 #include "rtl-sdr.h"
 #include "USBDriver.h"
-#include "StaticCircularBuffer.h"
+#include "SpscRing.h"
+#include "RTLSDRConfig.h"
+#include "cmsis_os.h"
+#include <array>
 
 
 enum usb_reg {
@@ -80,8 +83,20 @@ struct rtlsdr_tuner_iface_t {
 
 extern rtlsdr_dev_t static_dev;
 
-#define USB_IN_STREAM_SIZE 2048
-#define USB_BUFFER_SIZE 3
+struct RawSampleBuffer
+{
+	std::array<uint8_t,USB_IN_STREAM_SIZE> samples;
+	SampleBufferTime time;
+};
+
+struct RTLSDRCaptureStats
+{
+	uint32_t buffers;       /* Buffers filled by the dongle. */
+	uint32_t overruns;      /* Times every buffer was full and capture paused. */
+	TickType_t startTick;   /* xTaskGetTickCount() at StartCapture. */
+	uint32_t sampleRate;
+};
+
 class RTLSDR
 {
 public:
@@ -90,16 +105,29 @@ public:
     		             uint32_t  tunerFrequency,
     		             uint32_t  adcSampRate);
 
-	void GetNewRawSamples();
+	/* Capture streams into a ring of USB_BUFFER_COUNT buffers. The URB
+	 * completion interrupt publishes the filled buffer and submits the next
+	 * free one right away, so a transfer is outstanding while the decoder
+	 * works. Only when all buffers wait for the decoder does the dongle
+	 * pause, until NotifyRawSampleProcessed frees one. */
+	void StartCapture();
+	/* URB completion, interrupt context. */
 	void NotifyNewRawSampleRecived();
+	/* Task side: oldest filled buffer with its capture time, NULL if none
+	 * is pending. It stays valid until NotifyRawSampleProcessed. The first
+	 * buffer after a pause (and after StartCapture) is marked afterGap. */
+	const RawSampleBuffer* GetRawSamplesFromBuffer();
 	void NotifyRawSampleProcessed();
 
-
+	RTLSDRCaptureStats GetCaptureStats() const;
+	/* Sampled time over wall time since StartCapture, below 1.0 when the
+	 * dongle was paused or between transfers. */
+	float GetCaptureDutyCycle() const;
 
 	volatile bool IsDeviceReady() const;
-	uint8_t* GetRawSamplesFromBuffer();
-	//std::array<uint8_t,USB_IN_STREAM_SIZE>& GetRawSamplesFromBuffer();
 private:
+	void SubmitTransfer(bool afterGap);
+
 	void InitBaseband();
 	void WriteReg(uint8_t block, uint16_t addr, uint16_t val, uint8_t len);
 	void DemodWriteReg(uint8_t page, uint16_t addr, uint16_t val, uint8_t len);
@@ -123,7 +151,14 @@ private:
 	USBDriver* usbDriverHandle;
 	rtlsdr_dev_t *dev;
 
-	uint8_t buff[2048];
+	/* Produced from the URB interrupt, consumed by the acquisition task. */
+	SpscRing<RawSampleBuffer,USB_BUFFER_COUNT> sampleRing;
+	RawSampleBuffer* volatile transferBuffer;   /* Target of the URB in flight. */
+	volatile bool captureStalled;
+	volatile uint32_t buffersCaptured;
+	volatile uint32_t overruns;
+	TickType_t captureStartTick;
+	uint32_t sampleRate;
 
 	volatile bool deviceReady;
 };
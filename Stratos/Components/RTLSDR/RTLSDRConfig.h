@@ -0,0 +1,43 @@
+/*
+ * RTLSDRConfig.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef RTLSDR_RTLSDRCONFIG_H_
+#define RTLSDR_RTLSDRCONFIG_H_
+
+#include <cstdint>
+
+/* Stream geometry shared by the dongle driver and the decoder. Kept apart
+ * from RTLSDR.h so the decoder does not pull in the USB host stack. Bytes
+ * of I/Q per USB buffer: whole 512 byte bulk packets, so every URB ends on
+ * a packet boundary, and whole I/Q pairs. */
+#ifndef USB_IN_STREAM_SIZE
+#define USB_IN_STREAM_SIZE 2048
+#endif
+static_assert(USB_IN_STREAM_SIZE % 512 == 0, "USB_IN_STREAM_SIZE must be a multiple of the bulk packet size");
+static_assert(USB_IN_STREAM_SIZE % 2 == 0, "USB_IN_STREAM_SIZE must hold whole I/Q pairs");
+/* Sample buffers the dongle streams into, a power of two. One is being
+ * filled by the current URB, the others queue up while the decoder works. */
+#ifndef USB_BUFFER_COUNT
+#define USB_BUFFER_COUNT 4
+#endif
+
+/* Dongle sample rate, 2000000 or 2400000 (decoded by the multi-phase
+ * demodulator only). Passed to RTLSDR::OpenDevice and used as the decoder
+ * default, define it in the build to switch. */
+#ifndef ADS_B_SAMPLING
+#define ADS_B_SAMPLING 2000000U
+#endif
+
+/* Capture time of a sample buffer, stamped by the driver when its URB
+ * completes, i.e. right after its last sample. */
+struct SampleBufferTime
+{
+	uint32_t cycles;        /* CycleCounterNow() */
+	uint32_t tick;          /* xTaskGetTickCountFromISR() */
+	bool afterGap;          /* Samples were lost right before this buffer. */
+};
+
+#endif /* RTLSDR_RTLSDRCONFIG_H_ */
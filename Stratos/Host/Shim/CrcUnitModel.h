@@ -0,0 +1,52 @@
+/*
+ * CrcUnitModel.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef CRCUNITMODEL_H_
+#define CRCUNITMODEL_H_
+
+#include <cstdint>
+
+/* Software model of the STM32F7 CRC unit as used by the Mode S CRC engine:
+ * 32 bit programmable polynomial, byte input, MSB first, no bit reversal. */
+struct CrcUnitState
+{
+	uint32_t pol;
+	uint32_t init;
+	uint32_t dr;
+};
+
+inline CrcUnitState& CrcUnit()
+{
+	static CrcUnitState unit = { 0x04C11DB7U, 0xFFFFFFFFU, 0xFFFFFFFFU };
+	return unit;
+}
+
+inline void CrcUnitConfigure(uint32_t poly)
+{
+	CrcUnit().pol = poly;
+	CrcUnit().init = 0U;
+}
+
+inline void CrcUnitReset()
+{
+	CrcUnit().dr = CrcUnit().init;
+}
+
+inline void CrcUnitWrite(uint8_t byte)
+{
+	uint32_t crc = CrcUnit().dr ^ (uint32_t(byte) << 24);
+	for (int k = 0; k < 8; k++) {
+		crc = (crc & 0x80000000U) ? (crc << 1) ^ CrcUnit().pol : crc << 1;
+	}
+	CrcUnit().dr = crc;
+}
+
+inline uint32_t CrcUnitRead()
+{
+	return CrcUnit().dr;
+}
+
+#endif /* CRCUNITMODEL_H_ */
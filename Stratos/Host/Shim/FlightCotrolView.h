@@ -0,0 +1,74 @@
+/*
+ * FlightCotrolView.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef HOST_SHIM_FLIGHTCOTROLVIEW_H_
+#define HOST_SHIM_FLIGHTCOTROLVIEW_H_
+
+/* Host replacement for the emWin view, so FlightControlControler builds
+ * without the GUI. Snapshots are handed over as in the real view, and
+ * Refresh() reads every row of a new one the way its LISTVIEW fill does,
+ * so the tools can run it on a thread of their own as the GUI task. */
+
+#include "FlightControl.h"
+
+#include <cstring>
+
+class FlightCotrolView
+{
+public:
+    FlightCotrolView() : published(0U), refreshes(0U), warningShown(false), shownChars(0U) {}
+
+    AircraftSnapshot& NextSnapshot() { return snapshots.Back(); }
+    void Publish()
+    {
+        snapshots.Back().version = ++published;
+        snapshots.Publish();
+    }
+    bool Refresh()
+    {
+        if (!snapshots.Acquire()) {
+            return false;
+        }
+        const AircraftSnapshot& snapshot = snapshots.Front();
+        for (uint16_t i = 0; i < snapshot.count; i++) {
+            const AircraftSnapshotEntry& aircraft = snapshot.aircraft[i];
+            Show(aircraft.icaoStr);
+            if (aircraft.known & AircraftAltitude) {
+                Show(aircraft.altitudeStr);
+                Show(aircraft.positionStr);
+            }
+            if (aircraft.known & AircraftVelocity) {
+                Show(aircraft.velocityStr);
+                Show(aircraft.headingStr);
+            }
+            if (aircraft.known & AircraftFlightName) {
+                Show(aircraft.flightName);
+            }
+        }
+        refreshes++;
+        return true;
+    }
+    void ShowWarningMsg() { warningShown = true; }
+    void HideWarningMsg() { warningShown = false; }
+
+    /* Host only, from the thread that calls Refresh(). */
+    const AircraftSnapshot& GetSnapshot() const { return snapshots.Front(); }
+    uint32_t GetTimeMs() const { return snapshots.Front().timeMs; }
+    unsigned GetRefreshes() const { return refreshes; }
+    bool IsWarningShown() const { return warningShown; }
+    /* Characters shown by all refreshes. */
+    size_t GetShownChars() const { return shownChars; }
+private:
+    void Show(const char* text) { shownChars += strlen(text); }
+
+    AircraftSnapshots snapshots;
+    uint32_t published;
+    unsigned refreshes;
+    bool warningShown;
+    size_t shownChars;
+};
+
+#endif /* HOST_SHIM_FLIGHTCOTROLVIEW_H_ */
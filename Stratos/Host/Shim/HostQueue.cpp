@@ -0,0 +1,150 @@
+/*
+ * HostQueue.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+#include "cmsis_os.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+struct QueueDefinition
+{
+	UBaseType_t itemSize;
+	UBaseType_t highWaterMark;
+	std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+	(void)uxQueueLength;
+	QueueHandle_t queue = new QueueDefinition;
+	queue->itemSize = uxItemSize;
+	queue->highWaterMark = 0U;
+	return queue;
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+	delete xQueue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait)
+{
+	(void)xTicksToWait;
+	if(xQueue == NULL)
+	{
+		return errQUEUE_FULL;
+	}
+	const uint8_t* item = static_cast<const uint8_t*>(pvItemToQueue);
+	xQueue->items.emplace_back(item, item + xQueue->itemSize);
+	if(xQueue->items.size() > xQueue->highWaterMark)
+	{
+		xQueue->highWaterMark = xQueue->items.size();
+	}
+	return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait)
+{
+	(void)xTicksToWait;
+	if(xQueue == NULL || xQueue->items.empty())
+	{
+		return errQUEUE_EMPTY;
+	}
+	memcpy(pvBuffer, xQueue->items.front().data(), xQueue->itemSize);
+	xQueue->items.pop_front();
+	return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+	return (xQueue == NULL) ? 0U : xQueue->items.size();
+}
+
+UBaseType_t uxQueueHighWaterMark(QueueHandle_t xQueue)
+{
+	return (xQueue == NULL) ? 0U : xQueue->highWaterMark;
+}
+
+struct SemaphoreDefinition
+{
+	bool given;
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+	SemaphoreHandle_t semaphore = new SemaphoreDefinition;
+	semaphore->given = false;
+	return semaphore;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore)
+{
+	delete xSemaphore;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+	if(xSemaphore == NULL || xSemaphore->given)
+	{
+		return pdFAIL;
+	}
+	xSemaphore->given = true;
+	return pdPASS;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
+{
+	(void)xTicksToWait;
+	if(xSemaphore == NULL || !xSemaphore->given)
+	{
+		return pdFALSE;
+	}
+	xSemaphore->given = false;
+	return pdTRUE;
+}
+
+static std::recursive_mutex& CriticalSection()
+{
+	static std::recursive_mutex mutex;
+	return mutex;
+}
+
+void vPortEnterCritical(void)
+{
+	CriticalSection().lock();
+}
+
+void vPortExitCritical(void)
+{
+	CriticalSection().unlock();
+}
+
+/* 0 while the steady clock is in use. */
+static std::atomic<uint64_t> hostTimeSet(0U);
+
+uint64_t HostTimeNs(void)
+{
+	uint64_t ns = hostTimeSet.load(std::memory_order_relaxed);
+	if(ns != 0U)
+	{
+		return ns;
+	}
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void HostTimeSet(uint64_t ns)
+{
+	hostTimeSet.store(ns, std::memory_order_relaxed);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	return (TickType_t)(HostTimeNs() / (1000000000U / configTICK_RATE_HZ));
+}
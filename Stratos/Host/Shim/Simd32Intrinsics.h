@@ -0,0 +1,44 @@
+/*
+ * Simd32Intrinsics.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef SIMD32INTRINSICS_H_
+#define SIMD32INTRINSICS_H_
+
+#include <cstdint>
+
+/* Portable models of the Cortex-M7 DSP intrinsics used by the decoder
+ * (CMSIS cmsis_gcc.h names and semantics), so the SIMD32 kernels can be run
+ * and checked on the host. */
+
+inline uint32_t __UXTB16(uint32_t x)
+{
+	return x & 0x00FF00FFU;
+}
+
+inline uint32_t __SSUB16(uint32_t a, uint32_t b)
+{
+	const uint16_t lo = uint16_t(int16_t(a) - int16_t(b));
+	const uint16_t hi = uint16_t(int16_t(a >> 16) - int16_t(b >> 16));
+	return uint32_t(lo) | (uint32_t(hi) << 16);
+}
+
+inline uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift)
+{
+	return (a & 0x0000FFFFU) | ((b << shift) & 0xFFFF0000U);
+}
+
+inline uint32_t __PKHTB(uint32_t a, uint32_t b, uint32_t shift)
+{
+	return (a & 0xFFFF0000U) | ((b >> shift) & 0x0000FFFFU);
+}
+
+inline uint32_t __SMUAD(uint32_t a, uint32_t b)
+{
+	return uint32_t(int32_t(int16_t(a)) * int16_t(b) +
+					int32_t(int16_t(a >> 16)) * int16_t(b >> 16));
+}
+
+#endif /* SIMD32INTRINSICS_H_ */
@@ -0,0 +1,67 @@
+/*
+ * cmsis_os.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef HOST_SHIM_CMSIS_OS_H_
+#define HOST_SHIM_CMSIS_OS_H_
+
+/* Host replacement for the subset of the CMSIS-RTOS / FreeRTOS API used by
+ * the decoder core. Queues are unbounded FIFOs and never block, which is
+ * what a single threaded replay needs: the consumer drains the queue after
+ * every buffer instead of running in its own task. For the same reason
+ * semaphores never block either, a take without a pending give fails at
+ * once. Critical sections are a process wide recursive mutex. */
+
+#include <cstddef>
+#include <cstdint>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE         ((BaseType_t)0)
+#define pdTRUE          ((BaseType_t)1)
+#define pdPASS          (pdTRUE)
+#define pdFAIL          (pdFALSE)
+#define errQUEUE_FULL   ((BaseType_t)0)
+#define errQUEUE_EMPTY  ((BaseType_t)0)
+#define portMAX_DELAY   ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ ((TickType_t)1000)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+
+struct QueueDefinition;
+typedef struct QueueDefinition* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+void vQueueDelete(QueueHandle_t xQueue);
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait);
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
+
+struct SemaphoreDefinition;
+typedef struct SemaphoreDefinition* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait);
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+#define taskENTER_CRITICAL()    vPortEnterCritical()
+#define taskEXIT_CRITICAL()     vPortExitCritical()
+
+TickType_t xTaskGetTickCount(void);
+
+/* Host only: largest number of items that were waiting at the same time. */
+UBaseType_t uxQueueHighWaterMark(QueueHandle_t xQueue);
+
+/* Host only: nanoseconds behind xTaskGetTickCount and the host
+ * CycleCounterNow, the steady clock until a test sets the time itself, so
+ * it can step past counter wraps. */
+uint64_t HostTimeNs(void);
+void HostTimeSet(uint64_t ns);
+
+#endif /* HOST_SHIM_CMSIS_OS_H_ */
@@ -0,0 +1,128 @@
+/*
+ * CprBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Positions decoded per second by the integer CPR decoding of CprDecoder
+ * and by the floating point reference it replaced (CprReference.h), for
+ * global pairs and local frames of random positions within 500 km of the
+ * receiver. CprTest checks that the two agree.
+ *
+ * usage: CprBenchmark [--positions N] [--loops N] */
+
+#include "CprDecoder.h"
+#include "CprReference.h"
+#include "HostClock.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct Position
+{
+    int evenLat, evenLon;
+    int oddLat, oddLon;
+    bool oddNewer;
+    double refLat, refLon;      /* Within 0.5 degrees, for the local decode. */
+    CprAngle refLatAngle, refLonAngle;
+};
+
+static volatile int32_t sink;
+
+template<class TDecode>
+static double Time(const std::vector<Position>& positions, unsigned loops, TDecode decode)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned loop = 0; loop < loops; loop++) {
+        for (const Position& p : positions) {
+            decode(p);
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+static void Report(const char* name, double seconds, size_t decoded)
+{
+    double mhz = HostMHz();
+    printf("%-16s %6.2f Mpositions/s, %6.1f ns/position", name, decoded / seconds / 1e6, seconds * 1e9 / decoded);
+    if (mhz > 0.0) {
+        printf(", %5.0f cycles", seconds * 1e6 * mhz / decoded);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    unsigned count = 100000U;
+    unsigned loops = 20U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--positions") == 0 && i + 1 < argc) {
+            count = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--positions N] [--loops N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> offset(-4.5, 4.5);
+    std::uniform_real_distribution<double> near(-0.5, 0.5);
+    std::vector<Position> positions(count);
+    for (Position& p : positions) {
+        const double lat = 51.109402 + offset(rng);
+        const double lon = 17.059798 + offset(rng) * 1.6;
+        CprEncode(lat, lon, false, p.evenLat, p.evenLon);
+        CprEncode(lat, lon, true, p.oddLat, p.oddLon);
+        p.oddNewer = rng() & 1;
+        p.refLat = lat + near(rng);
+        p.refLon = lon + near(rng);
+        p.refLatAngle = CprAngleFromDegrees(p.refLat);
+        p.refLonAngle = CprAngleFromDegrees(p.refLon);
+    }
+    const size_t decoded = size_t(count) * loops;
+    printf("%u positions x %u loops\n", count, loops);
+
+    double seconds = Time(positions, loops, [](const Position& p) {
+        double lat = 0.0, lon = 0.0;
+        CprReferenceGlobal(p.evenLat, p.evenLon, p.oddLat, p.oddLon, p.oddNewer, lat, lon);
+        sink = int32_t(lat + lon);
+    });
+    Report("global float", seconds, decoded);
+    seconds = Time(positions, loops, [](const Position& p) {
+        CprAngle lat = 0, lon = 0;
+        CprGlobalDecode(p.evenLat, p.evenLon, p.oddLat, p.oddLon, p.oddNewer, lat, lon);
+        sink = lat ^ lon;
+    });
+    Report("global integer", seconds, decoded);
+
+    seconds = Time(positions, loops, [](const Position& p) {
+        double lat = 0.0, lon = 0.0;
+        CprReferenceLocal(p.oddNewer, p.oddLat, p.oddLon, p.refLat, p.refLon, lat, lon);
+        sink = int32_t(lat + lon);
+    });
+    Report("local float", seconds, decoded);
+    seconds = Time(positions, loops, [](const Position& p) {
+        CprAngle lat = 0, lon = 0;
+        CprLocalDecode(p.oddNewer, p.oddLat, p.oddLon, p.refLatAngle, p.refLonAngle, lat, lon);
+        sink = lat ^ lon;
+    });
+    Report("local integer", seconds, decoded);
+
+    seconds = Time(positions, loops, [](const Position& p) {
+        sink = CprReferenceNL(p.refLat);
+    });
+    Report("NL chain", seconds, decoded);
+    seconds = Time(positions, loops, [](const Position& p) {
+        sink = CprNL(int32_t(int64_t(p.refLatAngle) * 3540 >> 15));
+    });
+    Report("NL table", seconds, decoded);
+    return 0;
+}
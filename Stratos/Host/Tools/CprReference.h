@@ -0,0 +1,182 @@
+/*
+ * CprReference.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef CPRREFERENCE_H_
+#define CPRREFERENCE_H_
+
+#include <cmath>
+
+/* Floating point airborne CPR as in dump1090, the NL table as a chain of
+ * comparisons, which the integer CprDecoder replaced. Kept for the host
+ * tools to check and time the integer version against, together with an
+ * encoder (the same as SynthCapture's) that takes NL from its closed form. */
+
+#define CPR_SCALE 131072.0	// 2^17
+#define CPR_DLAT_EVEN (360.0 / 60.0)
+#define CPR_DLAT_ODD (360.0 / 59.0)
+
+inline int CprReferenceNL(double lat) {
+    if (lat < 0) lat = -lat; /* Table is simmetric about the equator. */
+    if (lat < 10.47047130) return 59;
+    if (lat < 14.82817437) return 58;
+    if (lat < 18.18626357) return 57;
+    if (lat < 21.02939493) return 56;
+    if (lat < 23.54504487) return 55;
+    if (lat < 25.82924707) return 54;
+    if (lat < 27.93898710) return 53;
+    if (lat < 29.91135686) return 52;
+    if (lat < 31.77209708) return 51;
+    if (lat < 33.53993436) return 50;
+    if (lat < 35.22899598) return 49;
+    if (lat < 36.85025108) return 48;
+    if (lat < 38.41241892) return 47;
+    if (lat < 39.92256684) return 46;
+    if (lat < 41.38651832) return 45;
+    if (lat < 42.80914012) return 44;
+    if (lat < 44.19454951) return 43;
+    if (lat < 45.54626723) return 42;
+    if (lat < 46.86733252) return 41;
+    if (lat < 48.16039128) return 40;
+    if (lat < 49.42776439) return 39;
+    if (lat < 50.67150166) return 38;
+    if (lat < 51.89342469) return 37;
+    if (lat < 53.09516153) return 36;
+    if (lat < 54.27817472) return 35;
+    if (lat < 55.44378444) return 34;
+    if (lat < 56.59318756) return 33;
+    if (lat < 57.72747354) return 32;
+    if (lat < 58.84763776) return 31;
+    if (lat < 59.95459277) return 30;
+    if (lat < 61.04917774) return 29;
+    if (lat < 62.13216659) return 28;
+    if (lat < 63.20427479) return 27;
+    if (lat < 64.26616523) return 26;
+    if (lat < 65.31845310) return 25;
+    if (lat < 66.36171008) return 24;
+    if (lat < 67.39646774) return 23;
+    if (lat < 68.42322022) return 22;
+    if (lat < 69.44242631) return 21;
+    if (lat < 70.45451075) return 20;
+    if (lat < 71.45986473) return 19;
+    if (lat < 72.45884545) return 18;
+    if (lat < 73.45177442) return 17;
+    if (lat < 74.43893416) return 16;
+    if (lat < 75.42056257) return 15;
+    if (lat < 76.39684391) return 14;
+    if (lat < 77.36789461) return 13;
+    if (lat < 78.33374083) return 12;
+    if (lat < 79.29428225) return 11;
+    if (lat < 80.24923213) return 10;
+    if (lat < 81.19801349) return 9;
+    if (lat < 82.13956981) return 8;
+    if (lat < 83.07199445) return 7;
+    if (lat < 83.99173563) return 6;
+    if (lat < 84.89166191) return 5;
+    if (lat < 85.75541621) return 4;
+    if (lat < 86.53536998) return 3;
+    if (lat < 87.00000000) return 2;
+    else return 1;
+}
+
+inline int CprReferenceN(double lat, bool odd)
+{
+	int n = CprReferenceNL(lat) - (odd ? 1 : 0);
+	return (n < 1) ? 1 : n;
+}
+
+inline double CprReferenceMod(double x, double y)
+{
+	return x - y * std::floor(x / y);
+}
+
+inline int CprReferenceModInt(int a, int b)
+{
+	int res = a % b;
+	return (res < 0) ? res + b : res;
+}
+
+inline bool CprReferenceGlobal(int evenLat, int evenLon, int oddLat, int oddLon, bool oddNewer, double& lat, double& lon)
+{
+	const int j = int(std::floor((59.0 * evenLat - 60.0 * oddLat) / CPR_SCALE + 0.5));
+	double latEven = CPR_DLAT_EVEN * (CprReferenceModInt(j, 60) + evenLat / CPR_SCALE);
+	double latOdd = CPR_DLAT_ODD * (CprReferenceModInt(j, 59) + oddLat / CPR_SCALE);
+	if(latEven >= 270.0)
+	{
+		latEven -= 360.0;
+	}
+	if(latOdd >= 270.0)
+	{
+		latOdd -= 360.0;
+	}
+	if(latEven < -90.0 || latEven > 90.0 || latOdd < -90.0 || latOdd > 90.0)
+	{
+		return false;
+	}
+
+	/* Both frames must come from the same longitude zone count. */
+	const int nl = CprReferenceNL(latEven);
+	if(nl != CprReferenceNL(latOdd))
+	{
+		return false;
+	}
+
+	const int m = int(std::floor((double(evenLon) * (nl - 1) - double(oddLon) * nl) / CPR_SCALE + 0.5));
+	const int n = CprReferenceN(oddNewer ? latOdd : latEven, oddNewer);
+	const int rawLon = oddNewer ? oddLon : evenLon;
+	lat = oddNewer ? latOdd : latEven;
+	lon = (360.0 / n) * (CprReferenceModInt(m, n) + rawLon / CPR_SCALE);
+	lon -= std::floor((lon + 180.0) / 360.0) * 360.0;
+	return true;
+}
+
+inline bool CprReferenceLocal(bool odd, int rawLat, int rawLon, double refLat, double refLon, double& lat, double& lon)
+{
+	const double cprLat = rawLat / CPR_SCALE;
+	const double cprLon = rawLon / CPR_SCALE;
+	const double dLat = odd ? CPR_DLAT_ODD : CPR_DLAT_EVEN;
+
+	const double j = std::floor(refLat / dLat) + std::floor(0.5 + CprReferenceMod(refLat, dLat) / dLat - cprLat);
+	lat = dLat * (j + cprLat);
+	if(lat < -90.0 || lat > 90.0 || std::fabs(lat - refLat) > dLat / 2.0)
+	{
+		return false;
+	}
+
+	const double dLon = 360.0 / CprReferenceN(lat, odd);
+	const double m = std::floor(refLon / dLon) + std::floor(0.5 + CprReferenceMod(refLon, dLon) / dLon - cprLon);
+	lon = dLon * (m + cprLon);
+	if(std::fabs(lon - refLon) > dLon / 2.0)
+	{
+		return false;
+	}
+	lon -= std::floor((lon + 180.0) / 360.0) * 360.0;
+	return true;
+}
+
+inline int CprEncoderNL(double lat)
+{
+	if(std::fabs(lat) >= 87.0)
+	{
+		return 1;
+	}
+	double a = 1.0 - std::cos(M_PI / 30.0);
+	double b = std::cos(M_PI / 180.0 * std::fabs(lat));
+	return int(std::floor(2.0 * M_PI / std::acos(1.0 - a / (b * b))));
+}
+
+inline void CprEncode(double lat, double lon, bool odd, int& rawLat, int& rawLon)
+{
+	double dlat = 360.0 / (odd ? 59.0 : 60.0);
+	double y = std::floor(131072.0 * std::fmod(lat + 360.0, dlat) / dlat + 0.5);
+	double rlat = dlat * (y / 131072.0 + std::floor(lat / dlat));
+	int nl = CprEncoderNL(rlat) - (odd ? 1 : 0);
+	double dlon = 360.0 / (nl > 0 ? nl : 1);
+	double x = std::floor(131072.0 * std::fmod(lon + 360.0, dlon) / dlon + 0.5);
+	rawLat = int(y) & 0x1FFFF;
+	rawLon = int(x) & 0x1FFFF;
+}
+
+#endif /* CPRREFERENCE_H_ */
@@ -0,0 +1,316 @@
+/*
+ * CprTest.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Test vectors for the airborne CPR decoding in CprDecoder. Checks the
+ * published example pair (8D40621D58C382D690C8AC2863A7 / ...86435CC412692AD6)
+ * globally and locally, NL of every grid latitude against the comparison
+ * chain, random frames against the floating point reference (CprReference.h)
+ * and a world wide grid of encoded positions. Finally flies a CprDecoder
+ * along a track to check the pair freshness, the switch to local decoding
+ * and the range and speed checks. Exits with 1 when anything is off by more
+ * than one CPR step.
+ *
+ * usage: CprTest [--frames N] [--seed N] */
+
+#include "CprDecoder.h"
+#include "CprReference.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+static unsigned failures;
+
+static void Check(bool ok, const char* what)
+{
+    if (!ok) {
+        printf("  FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static double Degrees(CprAngle angle)
+{
+    return angle * (360.0 / 4294967296.0);
+}
+
+/* One CPR step in latitude and in longitude at lat. */
+static double LatStep(bool odd)
+{
+    return 360.0 / (odd ? 59 : 60) / 131072.0;
+}
+
+static double LonStep(double lat, bool odd)
+{
+    return 360.0 / CprReferenceN(lat, odd) / 131072.0;
+}
+
+static double LonDiff(double a, double b)
+{
+    double d = std::fabs(a - b);
+    return d > 180.0 ? 360.0 - d : d;
+}
+
+static bool WithinStep(double lat, double lon, double refLat, double refLon, bool odd)
+{
+    return std::fabs(lat - refLat) <= LatStep(odd) && LonDiff(lon, refLon) <= LonStep(refLat, odd);
+}
+
+static void TestKnownPair()
+{
+    CprAngle lat, lon;
+    bool ok = CprGlobalDecode(93000, 51372, 74158, 50194, false, lat, lon);
+    printf("global, even newer: %.6f %.6f\n", Degrees(lat), Degrees(lon));
+    Check(ok && std::fabs(Degrees(lat) - 52.2572021484375) < 1e-6 && std::fabs(Degrees(lon) - 3.91937255859375) < 1e-6,
+          "global decode, even newer");
+
+    ok = CprGlobalDecode(93000, 51372, 74158, 50194, true, lat, lon);
+    printf("global, odd newer : %.6f %.6f\n", Degrees(lat), Degrees(lon));
+    Check(ok && std::fabs(Degrees(lat) - 52.26578017412606) < 1e-6 && std::fabs(Degrees(lon) - 3.938912527901786) < 1e-6,
+          "global decode, odd newer");
+
+    ok = CprLocalDecode(false, 93000, 51372, CprAngleFromDegrees(52.258), CprAngleFromDegrees(3.918), lat, lon);
+    printf("local, even       : %.6f %.6f\n", Degrees(lat), Degrees(lon));
+    Check(ok && std::fabs(Degrees(lat) - 52.2572021484375) < 1e-6 && std::fabs(Degrees(lon) - 3.91937255859375) < 1e-6,
+          "local decode, even");
+}
+
+/* Every even and odd grid latitude of the northern hemisphere, and its
+ * mirror image. */
+static void TestNL()
+{
+    unsigned wrong = 0, checked = 0;
+    for (int odd = 0; odd < 2; odd++) {
+        const int unitsPerStep = odd ? 60 : 59;
+        const double degreesPerStep = LatStep(odd);
+        for (int32_t step = 0; step * unitsPerStep <= CPR_LAT_UNITS_PER_TURN / 4; step++) {
+            const double lat = step * degreesPerStep;
+            const int expected = CprReferenceNL(lat);
+            checked++;
+            if (CprNL(step * unitsPerStep) != expected || CprNL(-step * unitsPerStep) != expected) {
+                if (wrong++ < 5) {
+                    printf("  NL(%.8f) = %d, expected %d\n", lat, CprNL(step * unitsPerStep), expected);
+                }
+            }
+        }
+    }
+    printf("NL: %u grid latitudes, %u wrong\n", checked, wrong);
+    Check(wrong == 0, "NL of every grid latitude");
+}
+
+/* Random raw frames, so also pairs no encoder would produce: the integer
+ * decode must refuse the same pairs as the reference and otherwise agree
+ * within one step. */
+static void TestAgainstReference(unsigned frames, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    unsigned globalRefused = 0, localRefused = 0, wrong = 0;
+    for (unsigned i = 0; i < frames; i++) {
+        const int evenLat = rng() & 0x1FFFF, evenLon = rng() & 0x1FFFF;
+        const int oddLat = rng() & 0x1FFFF, oddLon = rng() & 0x1FFFF;
+        const bool oddNewer = rng() & 1;
+        CprAngle lat, lon;
+        double refLat = 0.0, refLon = 0.0;
+
+        bool ok = CprGlobalDecode(evenLat, evenLon, oddLat, oddLon, oddNewer, lat, lon);
+        bool refOk = CprReferenceGlobal(evenLat, evenLon, oddLat, oddLon, oddNewer, refLat, refLon);
+        globalRefused += refOk ? 0 : 1;
+        if (ok != refOk || (ok && !WithinStep(Degrees(lat), Degrees(lon), refLat, refLon, oddNewer))) {
+            if (wrong++ < 5) {
+                printf("  global %05X %05X %05X %05X: %.6f %.6f (%d), reference %.6f %.6f (%d)\n", evenLat,
+                       evenLon, oddLat, oddLon, Degrees(lat), Degrees(lon), ok, refLat, refLon, refOk);
+            }
+        }
+
+        /* Reference anywhere off the poles, where every frame decodes. */
+        const double aroundLat = (rng() % 170000) / 1000.0 - 85.0;
+        const double aroundLon = (rng() % 360000) / 1000.0 - 180.0;
+        ok = CprLocalDecode(oddNewer, oddLat, oddLon, CprAngleFromDegrees(aroundLat), CprAngleFromDegrees(aroundLon),
+                            lat, lon);
+        refOk = CprReferenceLocal(oddNewer, oddLat, oddLon, aroundLat, aroundLon, refLat, refLon);
+        localRefused += refOk ? 0 : 1;
+        if (ok != refOk || (ok && !WithinStep(Degrees(lat), Degrees(lon), refLat, refLon, oddNewer))) {
+            if (wrong++ < 5) {
+                printf("  local %05X %05X around %.3f %.3f: %.6f %.6f (%d), reference %.6f %.6f (%d)\n", oddLat,
+                       oddLon, aroundLat, aroundLon, Degrees(lat), Degrees(lon), ok, refLat, refLon, refOk);
+            }
+        }
+    }
+    printf("reference: %u random pairs (%u refused globally, %u locally), %u disagree\n", frames, globalRefused,
+           localRefused, wrong);
+    Check(wrong == 0, "agreement with the floating point reference");
+}
+
+/* Every 0.37 degrees of latitude and 1.13 of longitude, both hemispheres.
+ * A pair straddling a zone boundary may refuse to decode, but must never
+ * decode wrong. */
+static void TestRoundTrip()
+{
+    unsigned points = 0, global = 0, local = 0, refused = 0, wrong = 0;
+    for (double lat = -86.9; lat <= 86.9; lat += 0.37) {
+        for (double lon = -179.9; lon < 180.0; lon += 1.13) {
+            int evenLat, evenLon, oddLat, oddLon;
+            CprEncode(lat, lon, false, evenLat, evenLon);
+            CprEncode(lat, lon, true, oddLat, oddLon);
+            points++;
+
+            for (int oddNewer = 0; oddNewer < 2; oddNewer++) {
+                CprAngle dLat, dLon;
+                if (!CprGlobalDecode(evenLat, evenLon, oddLat, oddLon, oddNewer, dLat, dLon)) {
+                    refused++;
+                    continue;
+                }
+                global++;
+                if (!WithinStep(Degrees(dLat), Degrees(dLon), lat, lon, oddNewer)) {
+                    if (wrong++ < 5) {
+                        printf("  global %.4f %.4f decoded as %.6f %.6f\n", lat, lon, Degrees(dLat), Degrees(dLon));
+                    }
+                }
+            }
+
+            /* Reference a degree off in both directions. */
+            for (int odd = 0; odd < 2; odd++) {
+                CprAngle dLat, dLon;
+                bool ok = CprLocalDecode(odd, odd ? oddLat : evenLat, odd ? oddLon : evenLon,
+                                         CprAngleFromDegrees(lat - 1.0), CprAngleFromDegrees(lon + 1.0), dLat, dLon);
+                local++;
+                if (!ok || !WithinStep(Degrees(dLat), Degrees(dLon), lat, lon, odd)) {
+                    if (wrong++ < 5) {
+                        printf("  local %.4f %.4f decoded as %.6f %.6f (%s)\n", lat, lon, Degrees(dLat),
+                               Degrees(dLon), ok ? "accepted" : "refused");
+                    }
+                }
+            }
+        }
+    }
+    printf("round trip: %u positions, %u global (%u zone boundary refusals), %u local, %u wrong\n",
+           points, global, refused, local, wrong);
+    Check(wrong == 0, "round trip within one CPR step");
+    Check(refused * 100U < points, "under 1% of the pairs refused");
+}
+
+/* Flies east at 450 kt from near the receiver, one frame every 500 ms
+ * alternating even and odd. */
+struct Flight
+{
+    double lat;
+    double lon;
+    uint32_t timeMs;
+    bool odd;
+
+    void Step(uint32_t ms)
+    {
+        timeMs += ms;
+        lon += 450.0 * 1852.0 / 3600.0 * (ms / 1000.0) / (111320.0 * std::cos(lat * M_PI / 180.0));
+        odd = !odd;
+    }
+
+    CprResult Feed(CprDecoder& decoder, const CprReceiver& receiver, CprAngle& lat, CprAngle& lon, int latError = 0)
+    {
+        int rawLat, rawLon;
+        CprEncode(this->lat, this->lon, odd, rawLat, rawLon);
+        return decoder.Decode(odd, (rawLat + latError) & 0x1FFFF, rawLon, timeMs, receiver, lat, lon);
+    }
+
+    bool OnTrack(CprAngle lat, CprAngle lon) const
+    {
+        return WithinStep(Degrees(lat), Degrees(lon), this->lat, this->lon, odd);
+    }
+};
+
+static void TestTrack()
+{
+    const CprReceiver receiver = { CprAngleFromDegrees(51.109402), CprAngleFromDegrees(17.059798),
+                                   uint32_t(CPR_DEFAULT_RANGE_KM * 1000.0F) };
+    CprDecoder decoder;
+    Flight flight = { 51.5, 16.0, 1000U, false };
+    CprAngle lat, lon;
+
+    Check(flight.Feed(decoder, receiver, lat, lon) == CprNoPosition, "single frame gives no position");
+    flight.Step(500U);
+    Check(flight.Feed(decoder, receiver, lat, lon) == CprGlobalPosition, "pair decodes globally");
+    Check(flight.OnTrack(lat, lon), "global position on track");
+
+    unsigned localOk = 0;
+    for (int i = 0; i < 100; i++) {
+        flight.Step(500U);
+        if (flight.Feed(decoder, receiver, lat, lon) == CprLocalPosition && flight.OnTrack(lat, lon)) {
+            localOk++;
+        }
+    }
+    printf("track: %u of 100 frames decoded locally on track\n", localOk);
+    Check(localOk == 100U, "local decoding follows the track");
+
+    /* 3000 steps of latitude, about 30 km in half a second. */
+    flight.Step(500U);
+    Check(flight.Feed(decoder, receiver, lat, lon, 3000) == CprRejected, "jump rejected by the speed check");
+    Check(!decoder.HasFix(), "rejection drops the fix");
+    flight.Step(500U);
+    Check(flight.Feed(decoder, receiver, lat, lon) == CprNoPosition, "no pair left after a rejection");
+    flight.Step(500U);
+    Check(flight.Feed(decoder, receiver, lat, lon) == CprGlobalPosition, "next pair decodes globally again");
+
+    /* Frames more than CPR_PAIR_MAX_AGE_MS apart do not pair. */
+    CprDecoder stale;
+    flight.Step(500U);
+    flight.Feed(stale, receiver, lat, lon);
+    flight.Step(CPR_PAIR_MAX_AGE_MS + 500U);
+    Check(flight.Feed(stale, receiver, lat, lon) == CprNoPosition, "stale pair not decoded");
+    flight.Step(500U);
+    Check(flight.Feed(stale, receiver, lat, lon) == CprGlobalPosition, "fresh pair decoded");
+
+    /* The fix is only a local reference for CPR_LOCAL_MAX_AGE_MS. */
+    flight.Step(CPR_LOCAL_MAX_AGE_MS + 500U);
+    Check(flight.Feed(stale, receiver, lat, lon) == CprNoPosition, "old fix not used as reference");
+
+    /* Far beyond the receiver's range. */
+    CprDecoder far;
+    Flight away = { 40.0, 2.0, 1000U, false };
+    away.Feed(far, receiver, lat, lon);
+    away.Step(500U);
+    Check(away.Feed(far, receiver, lat, lon) == CprRejected, "out of range rejected");
+    const CprReceiver anywhere = { 0, 0, 0U };
+    away.Step(500U);
+    away.Feed(far, anywhere, lat, lon);
+    away.Step(500U);
+    Check(away.Feed(far, anywhere, lat, lon) == CprGlobalPosition, "range check disabled with range 0");
+
+    /* The flat earth distance against the great circle. */
+    const CprAngle lat0 = CprAngleFromDegrees(51.0), lon0 = CprAngleFromDegrees(17.0);
+    Check(CprWithin(lat0, lon0, CprAngleFromDegrees(51.0), CprAngleFromDegrees(24.0), 492000U) &&
+          !CprWithin(lat0, lon0, CprAngleFromDegrees(51.0), CprAngleFromDegrees(24.0), 488000U),
+          "7 degrees of longitude at 51N are 490 km");
+    Check(CprWithin(lat0, lon0, CprAngleFromDegrees(55.4), CprAngleFromDegrees(17.0), 491000U) &&
+          !CprWithin(lat0, lon0, CprAngleFromDegrees(55.4), CprAngleFromDegrees(17.0), 488000U),
+          "4.4 degrees of latitude are 489 km");
+}
+
+int main(int argc, char** argv)
+{
+    unsigned frames = 1000000U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    TestKnownPair();
+    TestNL();
+    TestAgainstReference(frames, seed);
+    TestRoundTrip();
+    TestTrack();
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
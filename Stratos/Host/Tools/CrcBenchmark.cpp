@@ -0,0 +1,125 @@
+/*
+ * CrcBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Checks every Mode S CRC engine available in this build, and the
+ * incremental byte update, against the bit serial reference on random
+ * 56 and 112 bit frames, then measures the cost per frame of each.
+ *
+ * On the host the hardware engine runs on a software model of the STM32 CRC
+ * unit, so its timing says nothing about the target, only its result does.
+ *
+ * usage: CrcBenchmark [--frames N] [--loops N] */
+
+#include "ADSBMessage.h"
+#include "CycleCounter.h"
+#include "ModeSCrc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct Frame
+{
+	uint8_t msg[MODES_LONG_MSG_BYTES];
+	int bits;
+};
+
+static uint32_t IncrementalCrc(const uint8_t* msg, int bits)
+{
+	uint32_t crc = 0;
+	for (int k = 0; k < bits/8 - 3; k++) {
+		crc = ModeSCrcUpdate(crc, msg[k]);
+	}
+	return crc;
+}
+
+template <typename Func>
+static double TimeCrc(Func checksum, const std::vector<Frame>& frames, unsigned loops, uint32_t& sink)
+{
+	const uint32_t start = CycleCounterNow();
+	for (unsigned loop = 0; loop < loops; loop++) {
+		for (const Frame& frame : frames) {
+			sink += checksum(frame.msg, frame.bits);
+		}
+	}
+	const uint32_t ticks = CycleCounterNow() - start;
+	return double(ticks) * 1e9 / CycleCounterFrequency() / (double(loops) * frames.size());
+}
+
+int main(int argc, char** argv)
+{
+	unsigned count = 10000U;
+	unsigned loops = 100U;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			count = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+			loops = strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [--frames N] [--loops N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (count == 0U || loops == 0U) {
+		return 2;
+	}
+
+	/* Half short, half long frames with random payload. */
+	std::mt19937 rng(1090);
+	std::vector<Frame> frames(count);
+	for (unsigned n = 0; n < count; n++) {
+		frames[n].bits = (n & 1) ? MODES_LONG_MSG_BITS : MODES_SHORT_MSG_BITS;
+		for (int k = 0; k < MODES_LONG_MSG_BYTES; k++) {
+			frames[n].msg[k] = uint8_t(rng());
+		}
+	}
+
+	bool ok = true;
+	unsigned mismatches = 0;
+	for (const Frame& frame : frames) {
+		if (IncrementalCrc(frame.msg, frame.bits) != ModeSCrcReference(frame.msg, frame.bits)) {
+			mismatches++;
+		}
+	}
+	printf("%-12s mismatches %u\n", "incremental", mismatches);
+	ok = ok && mismatches == 0;
+
+	for (int type = 0; type < CrcEngineCount; type++) {
+		const CrcEngine* engine = GetCrcEngine(CrcEngineType(type));
+		if (engine == NULL) {
+			continue;
+		}
+		mismatches = 0;
+		for (const Frame& frame : frames) {
+			if (engine->checksum(frame.msg, frame.bits) != ModeSCrcReference(frame.msg, frame.bits)) {
+				mismatches++;
+			}
+		}
+		printf("%-12s mismatches %u\n", engine->name, mismatches);
+		ok = ok && mismatches == 0;
+	}
+
+	printf("\ntiming, %u frames x %u loops\n", count, loops);
+	printf("%-12s %10s %12s\n", "engine", "ns/frame", "Mframes/s");
+	uint32_t sink = 0;
+	for (int type = 0; type < CrcEngineCount; type++) {
+		const CrcEngine* engine = GetCrcEngine(CrcEngineType(type));
+		if (engine == NULL) {
+			continue;
+		}
+		const double ns = TimeCrc(engine->checksum, frames, loops, sink);
+		printf("%-12s %10.2f %12.2f%s\n", engine->name, ns, 1e3 / ns,
+			   type == CrcHardwareEngine ? "  (software model of the unit)" : "");
+	}
+	const double ns = TimeCrc(IncrementalCrc, frames, loops, sink);
+	printf("%-12s %10.2f %12.2f\n", "incremental", ns, 1e3 / ns);
+	printf("(checksum sum %08x)\n", sink);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+/*
+ * HostClock.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef HOSTCLOCK_H_
+#define HOSTCLOCK_H_
+
+#include <cstdio>
+
+/* Nominal clock of the host CPU in MHz from /proc/cpuinfo, 0 if unknown.
+ * Used to express host timings in cycles. */
+inline double HostMHz()
+{
+	FILE* cpuinfo = fopen("/proc/cpuinfo", "r");
+	double mhz = 0.0;
+	if (cpuinfo != NULL) {
+		char line[256];
+		while (fgets(line, sizeof(line), cpuinfo) != NULL) {
+			if (sscanf(line, "cpu MHz : %lf", &mhz) == 1) {
+				break;
+			}
+		}
+		fclose(cpuinfo);
+	}
+	return mhz;
+}
+
+#endif /* HOSTCLOCK_H_ */
@@ -0,0 +1,71 @@
+/*
+ * IQCapture.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef HOST_TOOLS_IQCAPTURE_H_
+#define HOST_TOOLS_IQCAPTURE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Read only memory mapping of a raw rtl-sdr capture (interleaved unsigned
+ * 8 bit I/Q, as written by rtl_sdr or SynthCapture). */
+class IQCapture
+{
+public:
+	IQCapture() : data(NULL), size(0U) {}
+	~IQCapture() { Close(); }
+
+	bool Open(const char* path)
+	{
+		int fd = open(path, O_RDONLY);
+		if(fd < 0)
+		{
+			return false;
+		}
+		struct stat st;
+		if(fstat(fd, &st) != 0 || st.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+		void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(mapping == MAP_FAILED)
+		{
+			return false;
+		}
+		madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+		data = static_cast<const uint8_t*>(mapping);
+		size = st.st_size;
+		return true;
+	}
+
+	void Close()
+	{
+		if(data != NULL)
+		{
+			munmap(const_cast<uint8_t*>(data), size);
+			data = NULL;
+			size = 0U;
+		}
+	}
+
+	const uint8_t* Data() const { return data; }
+	size_t Size() const { return size; }
+
+private:
+	IQCapture(const IQCapture&);
+	IQCapture& operator=(const IQCapture&);
+
+	const uint8_t* data;
+	size_t size;
+};
+
+#endif /* HOST_TOOLS_IQCAPTURE_H_ */
@@ -0,0 +1,262 @@
+/*
+ * IcaoTableBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Lookup, insert and erase cost of the aircraft table (IcaoTable) with 50,
+ * 500 and 5000 aircraft, against the std::list searched by ICAO string that
+ * FlightControl used before and against std::unordered_map. Lookups are of
+ * tracked (hit) and untracked (miss) addresses, insert/erase replaces a
+ * random tracked aircraft by a new one, as expiry does.
+ *
+ * The churn is checked against std::unordered_map as it runs: every key
+ * must be found with its own record, and the tool exits with 1 otherwise.
+ *
+ * usage: IcaoTableBenchmark [--ops N] [--seed N] */
+
+#include "AircraftRecord.h"
+#include "IcaoTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+static volatile uintptr_t sink;
+
+static std::string IcaoString(uint32_t icao)
+{
+    char buff[9];
+    sprintf(buff, "%.6lX", (unsigned long)icao);
+    return std::string(buff);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void Report(const char* container, const char* op, double seconds, unsigned ops)
+{
+    printf("  %-14s %-12s %8.1f ns/op\n", container, op, seconds * 1e9 / ops);
+}
+
+/* Addresses and the order they are looked up, replaced and inserted in. */
+struct Workload
+{
+    std::vector<uint32_t> tracked;
+    std::vector<uint32_t> untracked;
+    std::vector<uint32_t> hits;
+    std::vector<uint32_t> misses;
+    std::vector<size_t> victims;        /* Index into tracked. */
+    std::vector<uint32_t> arrivals;
+};
+
+static Workload MakeWorkload(size_t aircraft, unsigned ops, std::mt19937& rng)
+{
+    Workload w;
+    std::unordered_set<uint32_t> used;
+    auto fresh = [&]() {
+        uint32_t icao;
+        do {
+            icao = rng() & 0xFFFFFF;
+        } while (!used.insert(icao).second);
+        return icao;
+    };
+    for (size_t i = 0; i < aircraft; i++) {
+        w.tracked.push_back(fresh());
+        w.untracked.push_back(fresh());
+    }
+    for (unsigned i = 0; i < ops; i++) {
+        w.hits.push_back(w.tracked[rng() % aircraft]);
+        w.misses.push_back(w.untracked[rng() % aircraft]);
+        w.victims.push_back(rng() % aircraft);
+        w.arrivals.push_back(fresh());
+    }
+    return w;
+}
+
+template<size_t TAircraft>
+static bool RunTable(const Workload& w, unsigned ops)
+{
+    typedef IcaoTable<AircraftRecord, TAircraft> Table;
+    Table* table = new Table();
+    std::unordered_map<uint32_t, std::string> model;
+    for (uint32_t icao : w.tracked) {
+        table->Insert(icao, AircraftRecord());
+        model[icao] = IcaoString(icao);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = table->Find(w.hits[i]);
+    }
+    Report("IcaoTable", "lookup hit", Seconds(start), ops);
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = table->Find(w.misses[i]);
+    }
+    Report("IcaoTable", "lookup miss", Seconds(start), ops);
+
+    /* Every container pays the same for making the new record; the
+     * records carry no address of their own (AircraftRecord::Init binds
+     * them to the model's state), the table keys are checked instead. */
+    std::vector<uint32_t> tracked = w.tracked;
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        uint32_t& victim = tracked[w.victims[i]];
+        table->Erase(victim);
+        victim = w.arrivals[i];
+        sink = table->Insert(victim, AircraftRecord());
+    }
+    Report("IcaoTable", "erase+insert", Seconds(start), ops);
+
+    /* The same churn again, checked against the model. */
+    model.clear();
+    for (uint32_t icao : tracked) {
+        model[icao] = IcaoString(icao);
+    }
+    unsigned errors = 0;
+    for (unsigned i = 0; i < ops && errors == 0; i++) {
+        uint32_t& victim = tracked[w.victims[i]];
+        const uint32_t neighbour = tracked[(w.victims[i] + 1) % TAircraft];
+        const typename Table::Handle before = table->Find(neighbour);
+        const bool present = model.erase(victim) > 0;
+        errors += (table->Erase(victim) == present) ? 0 : 1;
+        victim = w.arrivals[i] ^ 0x800000U;
+        if (model.count(victim) == 0) {
+            errors += (table->Insert(victim, AircraftRecord()) == Table::InvalidHandle) ? 1 : 0;
+            model[victim] = IcaoString(victim);
+        }
+        /* Handles of the other entries do not move. */
+        if (neighbour != tracked[w.victims[i]] && model.count(neighbour)) {
+            errors += (table->Find(neighbour) == before) ? 0 : 1;
+        }
+        const bool found = table->Find(w.misses[i]) != Table::InvalidHandle;
+        errors += (found == (model.count(w.misses[i]) > 0)) ? 0 : 1;
+    }
+    for (const auto& entry : model) {
+        const typename Table::Handle handle = table->Find(entry.first);
+        if (handle == Table::InvalidHandle || IcaoString(table->GetKey(handle)) != entry.second) {
+            errors++;
+        }
+    }
+    size_t iterated = 0;
+    for (auto it = table->begin(); it != table->end(); ++it) {
+        iterated += model.count(table->GetKey(it.GetHandle()));
+    }
+    errors += (table->Size() == model.size() && iterated == model.size()) ? 0 : 1;
+
+    printf("  %zu buckets, longest probe %zu, %zu bytes (%zu per aircraft with the record), %s\n",
+           Table::IndexSize(), table->MaxProbeLength(), sizeof(Table), sizeof(Table) / TAircraft,
+           errors ? "FAILED" : "ok");
+    delete table;
+    return errors == 0;
+}
+
+static void RunList(const Workload& w, unsigned ops)
+{
+    /* The records held their address string, as they did then. */
+    typedef std::pair<std::string, AircraftRecord> Entry;
+    std::list<Entry> list;
+    for (uint32_t icao : w.tracked) {
+        list.push_back(Entry(IcaoString(icao), AircraftRecord()));
+    }
+    auto find = [&](const std::string& key) {
+        return std::find_if(list.begin(), list.end(),
+                            [&](const Entry& r) { return r.first == key; });
+    };
+
+    /* The key string is made from the message first, as it was. */
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = (find(IcaoString(w.hits[i])) != list.end());
+    }
+    Report("std::list", "lookup hit", Seconds(start), ops);
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = (find(IcaoString(w.misses[i])) != list.end());
+    }
+    Report("std::list", "lookup miss", Seconds(start), ops);
+
+    std::vector<uint32_t> tracked = w.tracked;
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        uint32_t& victim = tracked[w.victims[i]];
+        list.erase(find(IcaoString(victim)));
+        victim = w.arrivals[i];
+        list.push_back(Entry(IcaoString(victim), AircraftRecord()));
+    }
+    Report("std::list", "erase+insert", Seconds(start), ops);
+}
+
+static void RunUnorderedMap(const Workload& w, unsigned ops)
+{
+    std::unordered_map<uint32_t, AircraftRecord> map;
+    for (uint32_t icao : w.tracked) {
+        map[icao] = AircraftRecord();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = map.count(w.hits[i]);
+    }
+    Report("unordered_map", "lookup hit", Seconds(start), ops);
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        sink = map.count(w.misses[i]);
+    }
+    Report("unordered_map", "lookup miss", Seconds(start), ops);
+
+    std::vector<uint32_t> tracked = w.tracked;
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < ops; i++) {
+        uint32_t& victim = tracked[w.victims[i]];
+        map.erase(victim);
+        victim = w.arrivals[i];
+        map.emplace(victim, AircraftRecord());
+    }
+    Report("unordered_map", "erase+insert", Seconds(start), ops);
+}
+
+template<size_t TAircraft>
+static bool Run(unsigned ops, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    Workload w = MakeWorkload(TAircraft, ops, rng);
+    printf("%zu aircraft, %u ops\n", TAircraft, ops);
+    bool ok = RunTable<TAircraft>(w, ops);
+    /* The list is O(n), keep its run short. */
+    RunList(w, std::min<unsigned>(ops, 20000000U / TAircraft));
+    RunUnorderedMap(w, ops);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned ops = 200000U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--ops N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = Run<50>(ops, seed);
+    ok = Run<500>(ops, seed) && ok;
+    ok = Run<5000>(ops, seed) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+/*
+ * JournalBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Cost of keeping a consumer's copy of the model up to date from the
+ * change journal, against rescanning all records, with 8, 32 and 128
+ * aircraft tracked. Every simulated second --changes aircraft send a
+ * velocity and one aircraft is replaced by a new address; records expire
+ * 5 s after their last message. The consumer copies the address, the
+ * known bits, the altitude and the velocity of every aircraft.
+ *
+ * Per second of traffic the tool times the controller (messages, tick and
+ * journal flush), a consumer applying the journal and a consumer
+ * rescanning the table. After every second both copies must equal the
+ * model. A second, slow consumer reads only every --slow seconds, so the
+ * journal overruns it; it must be told to resync, rebuild from the table
+ * and then match the model again. The tool exits with 1 on any mismatch.
+ *
+ * usage: JournalBenchmark [--seconds N] [--changes N] [--slow N] [--seed N] */
+
+#include "FlightControlControler.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define JOURNAL_BATCH 64
+
+static volatile uint32_t sink;
+
+/* What a consumer keeps of every slot. */
+struct ConsumerCopy
+{
+    uint32_t icao[MAX_AIRCRAFT];        /* 0xFFFFFFFF when free. */
+    uint8_t known[MAX_AIRCRAFT];
+    uint32_t altitude[MAX_AIRCRAFT];
+    uint16_t velocity[MAX_AIRCRAFT];
+};
+
+static void CopySlot(ConsumerCopy& copy, const AircraftState& state, uint16_t slot, uint32_t icao)
+{
+    copy.icao[slot] = icao;
+    copy.known[slot] = state.known[slot];
+    copy.altitude[slot] = state.altitude[slot];
+    copy.velocity[slot] = state.velocity[slot];
+}
+
+static void Clear(ConsumerCopy& copy)
+{
+    for (uint16_t slot = 0; slot < MAX_AIRCRAFT; slot++) {
+        copy.icao[slot] = 0xFFFFFFFFU;
+        copy.known[slot] = 0U;
+    }
+}
+
+/* Rebuilds the copy from all records. */
+static void Rescan(ConsumerCopy& copy, const FlightControl& model)
+{
+    const AircraftTable& table = model.GetAllRecords();
+    Clear(copy);
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        CopySlot(copy, model.GetState(), it.GetHandle(), table.GetKey(it.GetHandle()));
+    }
+}
+
+/* Applies the consumer's journal entries, false if it has to resync. */
+static bool Apply(ConsumerCopy& copy, FlightControl& model, AircraftJournal::Consumer consumer)
+{
+    AircraftJournal& journal = model.GetJournal();
+    if (journal.NeedsResync(consumer)) {
+        return false;
+    }
+    AircraftChange changes[JOURNAL_BATCH];
+    size_t count;
+    while ((count = journal.Read(consumer, changes, JOURNAL_BATCH)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const AircraftChange& change = changes[i];
+            if (change.kind == AircraftExpired) {
+                copy.icao[change.slot] = 0xFFFFFFFFU;
+                copy.known[change.slot] = 0U;
+            } else {
+                CopySlot(copy, model.GetState(), change.slot, change.icao);
+            }
+        }
+    }
+    return true;
+}
+
+static bool Matches(const ConsumerCopy& copy, const FlightControl& model)
+{
+    const AircraftTable& table = model.GetAllRecords();
+    const AircraftState& state = model.GetState();
+    size_t tracked = 0;
+    for (uint16_t slot = 0; slot < MAX_AIRCRAFT; slot++) {
+        tracked += (copy.icao[slot] != 0xFFFFFFFFU) ? 1 : 0;
+    }
+    if (tracked != table.Size()) {
+        return false;
+    }
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        const uint16_t slot = it.GetHandle();
+        if (copy.icao[slot] != table.GetKey(slot) || copy.known[slot] != state.known[slot] ||
+            ((state.known[slot] & AircraftAltitude) && copy.altitude[slot] != state.altitude[slot]) ||
+            ((state.known[slot] & AircraftVelocity) && copy.velocity[slot] != state.velocity[slot])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static ADS_BMessage Velocity(uint32_t icao, uint32_t timeMs, int ewVelocity, int nsVelocity)
+{
+    ADS_BMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.SetTimestamp(uint64_t(timeMs) * ADS_B_SAMPLING / 1000U);
+    msg.signalLevel = 2000;
+    msg.msgtype = 17;
+    msg.longFrame = 1;
+    msg.crcStatus = CrcStatusOk;
+    msg.msg[0] = (17 << 3) | 5;
+    msg.msg[1] = icao >> 16;
+    msg.msg[2] = icao >> 8;
+    msg.msg[3] = icao;
+    const int ew = (ewVelocity < 0 ? -ewVelocity : ewVelocity) + 1;
+    const int ns = (nsVelocity < 0 ? -nsVelocity : nsVelocity) + 1;
+    msg.msg[4] = (19 << 3) | 1;
+    msg.msg[5] = ((ewVelocity < 0) << 2) | ((ew >> 8) & 3);
+    msg.msg[6] = ew & 0xFF;
+    msg.msg[7] = ((nsVelocity < 0) << 7) | ((ns >> 3) & 0x7F);
+    msg.msg[8] = (ns & 7) << 5;
+    msg.msg[9] = 1 << 2;
+    return msg;
+}
+
+struct Result
+{
+    double controllerUs;
+    double journalUs;
+    double rescanUs;
+    double tracked;
+    uint32_t entries;
+    unsigned resyncs;
+    bool ok;
+};
+
+static Result Run(unsigned fleet, unsigned seconds, unsigned changes, unsigned slow, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    SampleClock sampleClock;
+    sampleClock.SetSampleRate(ADS_B_SAMPLING);
+    FlightControl* model = new FlightControl();
+    FlightCotrolView* view = new FlightCotrolView();
+    FlightControlControler controler(*model, *view, sampleClock);
+    AircraftTimeouts timeouts = model->GetTimeouts();
+    timeouts.recordMs = 5000U;
+    model->SetTimeouts(timeouts);
+
+    AircraftJournal& journal = model->GetJournal();
+    const AircraftJournal::Consumer fast = journal.Subscribe();
+    const AircraftJournal::Consumer lagging = journal.Subscribe();
+    ConsumerCopy* fastCopy = new ConsumerCopy();
+    ConsumerCopy* slowCopy = new ConsumerCopy();
+    ConsumerCopy* scanCopy = new ConsumerCopy();
+    Clear(*fastCopy);
+    Clear(*slowCopy);
+
+    /* The fleet, less the aircraft still expiring after a replacement. */
+    std::vector<uint32_t> flying;
+    uint32_t nextIcao = 0x480000U;
+    const unsigned lingering = timeouts.recordMs / 1000U + 1U;
+    const unsigned active = (fleet > lingering + 1U) ? fleet - lingering : 1U;
+    for (unsigned i = 0; i < active; i++) {
+        flying.push_back(nextIcao++);
+    }
+
+    Result result = { 0.0, 0.0, 0.0, 0.0, 0U, 0U, true };
+    const uint32_t firstEntry = journal.GetHead();
+    const unsigned warmup = lingering + 2U;
+    for (unsigned s = 0; s < seconds + warmup; s++) {
+        std::vector<ADS_BMessage> messages;
+        if (s < warmup) {
+            for (uint32_t icao : flying) {
+                messages.push_back(Velocity(icao, s * 1000U, int(rng() % 400) - 200, int(rng() % 400) - 200));
+            }
+        } else {
+            flying[rng() % flying.size()] = nextIcao++;
+            for (unsigned c = 0; c < changes; c++) {
+                messages.push_back(Velocity(flying[rng() % flying.size()], s * 1000U + c,
+                                            int(rng() % 400) - 200, int(rng() % 400) - 200));
+            }
+        }
+        /* Keep the rest in the air without changing anything. */
+        if (s % 2U == 0U) {
+            for (uint32_t icao : flying) {
+                ADS_BMessage msg = Velocity(icao, s * 1000U + 999U, 0, 0);
+                msg.msg[4] = 0;
+                messages.push_back(msg);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const ADS_BMessage& msg : messages) {
+            controler.PassNewMessage(msg);
+        }
+        sampleClock.Advance(ADS_B_SAMPLING);
+        controler.ExpireRecords();
+        model->FlushChanges();
+        auto produced = std::chrono::steady_clock::now();
+        bool applied = Apply(*fastCopy, *model, fast);
+        auto journaled = std::chrono::steady_clock::now();
+        Rescan(*scanCopy, *model);
+        auto scanned = std::chrono::steady_clock::now();
+        sink = scanCopy->known[0];
+
+        if (s >= warmup) {
+            result.controllerUs += std::chrono::duration<double>(produced - start).count() * 1e6;
+            result.journalUs += std::chrono::duration<double>(journaled - produced).count() * 1e6;
+            result.rescanUs += std::chrono::duration<double>(scanned - journaled).count() * 1e6;
+            result.tracked += model->GetAllRecords().Size();
+        }
+        if (!applied || !Matches(*fastCopy, *model) || !Matches(*scanCopy, *model)) {
+            printf("  second %u: consumer copy does not match the model\n", s);
+            result.ok = false;
+            break;
+        }
+        if (s % slow == slow - 1U) {
+            if (!Apply(*slowCopy, *model, lagging)) {
+                result.resyncs++;
+                journal.Resync(lagging);
+                Rescan(*slowCopy, *model);
+            }
+            if (!Matches(*slowCopy, *model)) {
+                printf("  second %u: slow consumer does not match the model\n", s);
+                result.ok = false;
+                break;
+            }
+        }
+    }
+    result.entries = journal.GetHead() - firstEntry;
+    result.controllerUs /= seconds;
+    result.journalUs /= seconds;
+    result.rescanUs /= seconds;
+    result.tracked /= seconds;
+
+    delete scanCopy;
+    delete slowCopy;
+    delete fastCopy;
+    delete view;
+    delete model;
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned seconds = 20000U;
+    unsigned changes = 8U;
+    unsigned slow = 200U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--changes") == 0 && i + 1 < argc) {
+            changes = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--slow") == 0 && i + 1 < argc) {
+            slow = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--changes N] [--slow N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds == 0U || changes == 0U || slow == 0U) {
+        fprintf(stderr, "seconds, changes and slow must be positive\n");
+        return 2;
+    }
+
+    printf("journal of %u entries, %u changes per second, slow consumer every %u s\n",
+           AIRCRAFT_JOURNAL_SIZE, changes, slow);
+    printf("tracked  controller     journal      rescan   entries/s  resyncs\n");
+    bool ok = true;
+    const unsigned fleets[] = { 8U, 32U, MAX_AIRCRAFT };
+    for (unsigned fleet : fleets) {
+        Result r = Run(fleet, seconds, changes, slow, seed);
+        printf("%7.1f %8.2f us %8.3f us %8.3f us %11.1f %8u  %s\n", r.tracked, r.controllerUs, r.journalUs, r.rescanUs,
+               double(r.entries) / seconds, r.resyncs, r.ok ? "ok" : "FAILED");
+        ok = ok && r.ok;
+    }
+    return ok ? 0 : 1;
+}
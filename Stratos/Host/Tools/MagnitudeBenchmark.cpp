@@ -0,0 +1,178 @@
+/*
+ * MagnitudeBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Checks every magnitude kernel available in this build against the
+ * reference table and measures its cost per sample.
+ *
+ * Equivalence: all 65536 raw I/Q pairs are converted, once from an aligned
+ * and once from an odd offset so the scalar tails run too. Exact kernels
+ * must match the reference bit for bit, approximate ones must stay within
+ * MAX_APPROX_ERROR of it, and the 8 bit output must equal the 16 bit one >> 8.
+ *
+ * Timing: a USB buffer worth of samples (from a capture, or synthetic noise
+ * when none is given) is converted repeatedly. Cycles per sample are derived
+ * from the host clock frequency, taken from /proc/cpuinfo or --mhz.
+ *
+ * usage: MagnitudeBenchmark [capture.iq] [--iterations N] [--mhz F] */
+
+#include "ADSBDecoder.h"
+#include "CycleCounter.h"
+#include "HostClock.h"
+#include "IQCapture.h"
+#include "MagnitudeKernels.h"
+#include "MagnitudeLUT.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define MAX_APPROX_ERROR 0.045
+
+static bool CheckKernel(const MagnitudeKernel& kernel, const std::vector<uint8_t>& raw,
+						const std::vector<uint16_t>& reference)
+{
+	const uint32_t pairs = MAGNITUDE_RAW_IQ_LUT_SIZE;
+	bool ok = true;
+
+	/* Odd start offset and length exercise unaligned loads and the tails. */
+	for (uint32_t skip = 0; skip < 2; skip++) {
+		const uint32_t count = pairs - skip * 3;
+		std::vector<uint16_t> magnitude(count);
+		std::vector<uint8_t> magnitude8(count);
+		kernel.compute(raw.data() + 2*skip, magnitude.data(), count);
+		kernel.compute8(raw.data() + 2*skip, magnitude8.data(), count);
+
+		uint32_t mismatches = 0;
+		uint32_t mismatches8 = 0;
+		double maxError = 0.0;
+		for (uint32_t k = 0; k < count; k++) {
+			const uint16_t expected = reference[k + skip];
+			if (magnitude[k] != expected) {
+				mismatches++;
+				const double error = fabs(double(magnitude[k]) - expected) / (expected ? expected : 1);
+				if (error > maxError) {
+					maxError = error;
+				}
+			}
+			if (magnitude8[k] != (magnitude[k] >> 8)) {
+				mismatches8++;
+			}
+		}
+
+		if (skip == 0) {
+			printf("%-8s %-6s mismatches %5u, max error %5.2f%%",
+				   kernel.name, kernel.exact ? "exact" : "approx", mismatches, maxError * 100.0);
+		}
+		if ((kernel.exact && mismatches != 0) || maxError > MAX_APPROX_ERROR || mismatches8 != 0) {
+			ok = false;
+		}
+	}
+	printf("  %s\n", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+template <typename T, typename Func>
+static double TimeKernel(Func compute, const uint8_t* raw, uint32_t buffers, unsigned iterations)
+{
+	std::vector<T> magnitude(MODES_MAGNITUDE_SAMPLES);
+	uint64_t ticks = 0;
+	volatile T sink = 0;
+
+	for (unsigned it = 0; it < iterations; it++) {
+		const uint8_t* buffer = raw + (it % buffers) * USB_IN_STREAM_SIZE;
+		const uint32_t start = CycleCounterNow();
+		compute(buffer, magnitude.data(), MODES_MAGNITUDE_SAMPLES);
+		ticks += uint32_t(CycleCounterNow() - start);
+		sink = sink + magnitude[it % MODES_MAGNITUDE_SAMPLES];
+	}
+	return double(ticks) * 1e9 / CycleCounterFrequency() / (double(iterations) * MODES_MAGNITUDE_SAMPLES);
+}
+
+int main(int argc, char** argv)
+{
+	const char* path = NULL;
+	unsigned iterations = 20000U;
+	double mhz = HostMHz();
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+			iterations = strtoul(argv[++i], NULL, 0);
+		} else if (strcmp(argv[i], "--mhz") == 0 && i + 1 < argc) {
+			mhz = atof(argv[++i]);
+		} else if (path == NULL && argv[i][0] != '-') {
+			path = argv[i];
+		} else {
+			fprintf(stderr, "usage: %s [capture.iq] [--iterations N] [--mhz F]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	/* Every raw pair once, reference from the double precision formula. */
+	std::vector<uint8_t> allPairs(2 * MAGNITUDE_RAW_IQ_LUT_SIZE);
+	std::vector<uint16_t> reference(MAGNITUDE_RAW_IQ_LUT_SIZE);
+	for (uint32_t iq = 0; iq < MAGNITUDE_RAW_IQ_LUT_SIZE; iq++) {
+		const int i = int(iq & 0xFF) - 127;
+		const int q = int(iq >> 8) - 127;
+		allPairs[2*iq] = uint8_t(iq & 0xFF);
+		allPairs[2*iq+1] = uint8_t(iq >> 8);
+		reference[iq] = uint16_t(round(sqrt(i*i+q*q) * MAGNITUDE_SCALE));
+	}
+
+	printf("equivalence against round(sqrt(i*i+q*q)*%d), %d pairs\n", MAGNITUDE_SCALE, MAGNITUDE_RAW_IQ_LUT_SIZE);
+	bool ok = true;
+	for (int type = 0; type < MagnitudeKernelCount; type++) {
+		const MagnitudeKernel* kernel = GetMagnitudeKernel(MagnitudeKernelType(type));
+		if (kernel != NULL) {
+			ok = CheckKernel(*kernel, allPairs, reference) && ok;
+		}
+	}
+
+	/* Timing input: the capture, or Gaussian noise with sparse strong pulses. */
+	std::vector<uint8_t> synthetic;
+	IQCapture capture;
+	const uint8_t* raw;
+	uint32_t buffers;
+	if (path != NULL) {
+		if (capture.Open(path) == false || capture.Size() < USB_IN_STREAM_SIZE) {
+			fprintf(stderr, "cannot map %s\n", path);
+			return 1;
+		}
+		raw = capture.Data();
+		buffers = capture.Size() / USB_IN_STREAM_SIZE;
+	} else {
+		std::mt19937 rng(1090);
+		std::normal_distribution<double> noise(127.0, 6.0);
+		buffers = 64;
+		synthetic.resize(buffers * USB_IN_STREAM_SIZE);
+		for (size_t k = 0; k < synthetic.size(); k++) {
+			double v = noise(rng) + ((k / 2) % 97 < 8 ? 60.0 : 0.0);
+			synthetic[k] = uint8_t(v < 0.0 ? 0.0 : (v > 255.0 ? 255.0 : v));
+		}
+		raw = synthetic.data();
+	}
+
+	printf("\ntiming, %u buffers of %d samples, %s\n", iterations, MODES_MAGNITUDE_SAMPLES,
+		   path != NULL ? path : "synthetic noise");
+	printf("%-8s %10s %10s %12s %12s\n", "kernel", "ns/sample", "Msample/s", "cycles/smp", "8bit cyc/smp");
+	for (int type = 0; type < MagnitudeKernelCount; type++) {
+		const MagnitudeKernel* kernel = GetMagnitudeKernel(MagnitudeKernelType(type));
+		if (kernel == NULL) {
+			continue;
+		}
+		const double ns = TimeKernel<uint16_t>(kernel->compute, raw, buffers, iterations);
+		const double ns8 = TimeKernel<uint8_t>(kernel->compute8, raw, buffers, iterations);
+		printf("%-8s %10.3f %10.1f %12.2f %12.2f%s\n", kernel->name, ns, 1e3 / ns,
+			   ns * mhz / 1e3, ns8 * mhz / 1e3,
+			   kernel == GetDefaultMagnitudeKernel() ? "  (default)" : "");
+	}
+	if (mhz == 0.0) {
+		printf("clock frequency unknown, pass --mhz for cycle counts\n");
+	}
+	return ok ? 0 : 1;
+}
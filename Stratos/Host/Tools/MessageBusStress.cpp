@@ -0,0 +1,171 @@
+/*
+ * MessageBusStress.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Deterministic producer/consumer stress test of MessageBus. A seeded
+ * random schedule alternates producer bursts, consumer drains of random
+ * batch size and stalls of the consumer long enough to overflow the bus.
+ * Every drained batch is compared with a reference model of the drop
+ * policy, and the counters are checked against the model at the end. The
+ * same seed always gives the same schedule, so a failure is reproducible.
+ *
+ * usage: MessageBusStress [--steps N] [--seed N] */
+
+#include "ADSBMessage.h"
+#include "MessageBus.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+
+static const char* const policyNames[MessageDropPolicyCount] = { "oldest", "newest", "positions" };
+
+/* DF17 identification, airborne position or velocity, good or bad CRC.
+ * The sequence number travels in the timestamp. */
+static ADS_BMessage MakeMessage(uint64_t seq, std::mt19937& rng)
+{
+    static const uint8_t meTypes[] = { 4 << 3, 11 << 3, (19 << 3) | 1 };
+    ADS_BMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg[0] = 17 << 3;
+    msg.msg[4] = meTypes[rng() % 3];
+    msg.msgtype = 17;
+    msg.longFrame = 1;
+    msg.crcStatus = (rng() % 4) ? CrcStatusOk : CrcStatusBad;
+    msg.SetTimestamp(seq);
+    return msg;
+}
+
+struct ModelEntry
+{
+    uint64_t seq;
+    bool position;
+};
+
+/* The policy as a plain deque. Returns false when a message is dropped. */
+static bool ModelPublish(std::deque<ModelEntry>& model, MessageDropPolicy policy, const ModelEntry& entry,
+                         uint32_t& droppedNewest, uint32_t& droppedOldest)
+{
+    if (model.size() < MESSAGE_BUS_CAPACITY) {
+        model.push_back(entry);
+        return true;
+    }
+    if (policy == DropOldest) {
+        model.pop_front();
+        model.push_back(entry);
+        droppedOldest++;
+        return false;
+    }
+    if (policy == DropKeepPositions && entry.position) {
+        for (auto it = model.begin(); it != model.end(); ++it) {
+            if (!it->position) {
+                model.erase(it);
+                model.push_back(entry);
+                droppedOldest++;
+                return false;
+            }
+        }
+    }
+    droppedNewest++;
+    return false;
+}
+
+static bool Run(MessageDropPolicy policy, unsigned steps, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    MessageBus bus;
+    bus.SetDropPolicy(policy);
+    std::deque<ModelEntry> model;
+    uint32_t droppedNewest = 0, droppedOldest = 0, delivered = 0, highWater = 0;
+    uint64_t seq = 0;
+    unsigned errors = 0;
+    ADS_BMessage batch[MESSAGE_BUS_BATCH];
+
+    for (unsigned step = 0; step < steps && errors == 0; step++) {
+        /* Bursts of up to a bus worth, the consumer stalls one step in
+         * eight and otherwise takes one to MESSAGE_BUS_BATCH messages a
+         * few times: about as fast as the producer, so the bus runs both
+         * empty and full. */
+        unsigned burst = rng() % MESSAGE_BUS_CAPACITY;
+        for (unsigned k = 0; k < burst; k++) {
+            ADS_BMessage msg = MakeMessage(seq, rng);
+            ModelEntry entry = { seq++, MessageBus::IsPosition(msg) };
+            bool expected = ModelPublish(model, policy, entry, droppedNewest, droppedOldest);
+            if (model.size() > highWater) highWater = model.size();
+            if (bus.Publish(msg) != expected) {
+                printf("  step %u: Publish returned %d, expected %d\n", step, !expected, expected);
+                errors++;
+            }
+        }
+        if (rng() % 8 == 0) continue;
+
+        unsigned drains = 1 + rng() % 4;
+        for (unsigned d = 0; d < drains; d++) {
+            size_t want = 1 + rng() % MESSAGE_BUS_BATCH;
+            size_t got = bus.Drain(batch, want);
+            size_t expected = model.size() < want ? model.size() : want;
+            if (got != expected) {
+                printf("  step %u: drained %zu, expected %zu\n", step, got, expected);
+                errors++;
+                break;
+            }
+            for (size_t i = 0; i < got; i++) {
+                if (batch[i].Timestamp() != model.front().seq) {
+                    printf("  step %u: got message %llu, expected %llu\n", step,
+                           (unsigned long long)batch[i].Timestamp(), (unsigned long long)model.front().seq);
+                    errors++;
+                    break;
+                }
+                model.pop_front();
+            }
+            delivered += got;
+        }
+        if (bus.Pending() != model.size()) {
+            printf("  step %u: %zu pending, expected %zu\n", step, bus.Pending(), model.size());
+            errors++;
+        }
+    }
+
+    MessageBusStats stats = bus.GetStats();
+    if (stats.published != seq || stats.delivered != delivered ||
+        stats.droppedNewest != droppedNewest || stats.droppedOldest != droppedOldest ||
+        stats.highWater != highWater ||
+        stats.published != stats.delivered + stats.droppedNewest + stats.droppedOldest + bus.Pending()) {
+        printf("  counters do not match the model\n");
+        errors++;
+    }
+    printf("%-10s published %lu, delivered %lu, dropped %lu newest %lu oldest, high water %lu, %lu batches: %s\n",
+           policyNames[policy], (unsigned long)stats.published, (unsigned long)stats.delivered,
+           (unsigned long)stats.droppedNewest, (unsigned long)stats.droppedOldest,
+           (unsigned long)stats.highWater, (unsigned long)stats.batches, errors ? "FAILED" : "ok");
+    return errors == 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned steps = 100000U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--steps N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("bus capacity %d, batch %d, %u steps, seed %lu\n", MESSAGE_BUS_CAPACITY, MESSAGE_BUS_BATCH,
+           steps, (unsigned long)seed);
+    bool ok = true;
+    for (int policy = 0; policy < MessageDropPolicyCount; policy++) {
+        ok = Run(MessageDropPolicy(policy), steps, seed) && ok;
+    }
+    return ok ? 0 : 1;
+}
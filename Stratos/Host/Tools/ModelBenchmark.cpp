@@ -0,0 +1,425 @@
+/*
+ * ModelBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Runs simulated traffic through FlightControlControler and the
+ * FlightControl model, with the host stand-in for the view, and reports
+ * the model's memory footprint per aircraft and the controller time per
+ * message and per tick.
+ *
+ * A fleet of aircraft flies straight lines around the receiver and sends
+ * identification, velocity and even/odd position squitters, --rate sets of
+ * position pairs and velocities per second (squitters are sent at 2 Hz
+ * each, a busy receiver hears several aircraft per address slot). Every
+ * --turnover seconds an aircraft leaves and a new address takes its place,
+ * so records keep expiring and being added. With --position-gap N an
+ * aircraft sends positions only every N seconds and is predicted in
+ * between.
+ *
+ * The messages are built before the run; from the moment the model is
+ * constructed on, global operator new is counted and any allocation fails
+ * the run. At the end every aircraft that has been transmitting for 10 s
+ * (plus the position gap) must be tracked with its callsign, altitude and
+ * a position within 2 km of where it is, and the view's strings must
+ * match. After every view update the predicted positions are compared
+ * with the simulated ones, and the mean and largest error are printed.
+ * An aircraft that left must lose its position and velocity once their
+ * timeouts passed, stay tracked until DEFAULT_LIVE_SPAN and be gone a
+ * wheel slot after it.
+ *
+ * usage: ModelBenchmark [--aircraft N] [--seconds N] [--turnover N] [--rate N]
+ *                       [--position-gap N] [--seed N] */
+
+#include "CprReference.h"
+#include "FlightControlControler.h"
+#include "HostClock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+#define MODEL_REF_LAT 51.109402
+#define MODEL_REF_LON 17.059798
+#define MODEL_MAX_POSITION_ERROR_M 2000.0
+
+static bool countAllocations = false;
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    if (countAllocations) {
+        allocations++;
+    }
+    /* The default operator delete frees it. */
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/* Where an aircraft is at the end of a second. */
+struct Truth
+{
+    uint32_t icao;
+    double lat;
+    double lon;
+};
+
+struct SimAircraft
+{
+    uint32_t icao;
+    double lat;
+    double lon;
+    double speedKts;
+    double track;               /* Radians from north. */
+    int altitude;
+    char callsign[9];
+    bool odd;
+    unsigned enterS;            /* First second it transmits in. */
+    unsigned leaveS;            /* Stops transmitting at this second. */
+};
+
+/* An aircraft that stopped transmitting, and whether it was tracked then. */
+struct Departure
+{
+    uint32_t icao;
+    unsigned lastS;             /* Last second it transmitted in. */
+    bool tracked;
+};
+
+static int AisChar(char c)
+{
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 1;
+    if (c >= '0' && c <= '9') return c;
+    return 32;
+}
+
+static ADS_BMessage NewMessage(uint32_t icao, uint32_t timeMs)
+{
+    ADS_BMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.SetTimestamp(uint64_t(timeMs) * ADS_B_SAMPLING / 1000U);
+    msg.signalLevel = 2000;
+    msg.msgtype = 17;
+    msg.longFrame = 1;
+    msg.crcStatus = CrcStatusOk;
+    msg.msg[0] = (17 << 3) | 5;
+    msg.msg[1] = icao >> 16;
+    msg.msg[2] = icao >> 8;
+    msg.msg[3] = icao;
+    return msg;
+}
+
+static ADS_BMessage Identification(const SimAircraft& ac, uint32_t timeMs)
+{
+    ADS_BMessage msg = NewMessage(ac.icao, timeMs);
+    int c[8];
+    for (int i = 0; i < 8; i++) {
+        c[i] = AisChar(ac.callsign[i]);
+    }
+    msg.msg[4] = (4 << 3) | 3;
+    msg.msg[5] = (c[0] << 2) | (c[1] >> 4);
+    msg.msg[6] = ((c[1] & 15) << 4) | (c[2] >> 2);
+    msg.msg[7] = ((c[2] & 3) << 6) | c[3];
+    msg.msg[8] = (c[4] << 2) | (c[5] >> 4);
+    msg.msg[9] = ((c[5] & 15) << 4) | (c[6] >> 2);
+    msg.msg[10] = ((c[6] & 3) << 6) | c[7];
+    return msg;
+}
+
+static ADS_BMessage Velocity(const SimAircraft& ac, uint32_t timeMs)
+{
+    ADS_BMessage msg = NewMessage(ac.icao, timeMs);
+    const int ewVelocity = int(std::lround(ac.speedKts * std::sin(ac.track)));
+    const int nsVelocity = int(std::lround(ac.speedKts * std::cos(ac.track)));
+    const int ew = (ewVelocity < 0 ? -ewVelocity : ewVelocity) + 1;
+    const int ns = (nsVelocity < 0 ? -nsVelocity : nsVelocity) + 1;
+    const int vr = 1;
+    msg.msg[4] = (19 << 3) | 1;
+    msg.msg[5] = ((ewVelocity < 0) << 2) | ((ew >> 8) & 3);
+    msg.msg[6] = ew & 0xFF;
+    msg.msg[7] = ((nsVelocity < 0) << 7) | ((ns >> 3) & 0x7F);
+    msg.msg[8] = ((ns & 7) << 5) | ((vr >> 6) & 7);
+    msg.msg[9] = (vr & 0x3F) << 2;
+    return msg;
+}
+
+static ADS_BMessage Position(SimAircraft& ac, uint32_t timeMs)
+{
+    ADS_BMessage msg = NewMessage(ac.icao, timeMs);
+    int yz, xz;
+    CprEncode(ac.lat, ac.lon, ac.odd, yz, xz);
+    const int n = (ac.altitude + 1000) / 25;
+    msg.msg[4] = (11 << 3);
+    msg.msg[5] = ((n >> 4) << 1) | 1;
+    msg.msg[6] = ((n & 15) << 4) | (ac.odd << 2) | ((yz >> 15) & 3);
+    msg.msg[7] = (yz >> 7) & 0xFF;
+    msg.msg[8] = ((yz & 0x7F) << 1) | ((xz >> 16) & 1);
+    msg.msg[9] = (xz >> 8) & 0xFF;
+    msg.msg[10] = xz & 0xFF;
+    ac.odd = !ac.odd;
+    return msg;
+}
+
+static SimAircraft NewAircraft(std::mt19937& rng, uint32_t icao, unsigned nowS, unsigned turnover)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    SimAircraft ac;
+    ac.icao = icao;
+    ac.lat = MODEL_REF_LAT + (unit(rng) - 0.5) * 3.0;
+    ac.lon = MODEL_REF_LON + (unit(rng) - 0.5) * 4.5;
+    ac.speedKts = 150.0 + unit(rng) * 350.0;
+    ac.track = unit(rng) * 2.0 * M_PI;
+    ac.altitude = 1000 + int(unit(rng) * 38000.0) / 25 * 25;
+    snprintf(ac.callsign, sizeof(ac.callsign), "SIM%04u ", unsigned(icao % 10000U));
+    ac.odd = rng() & 1;
+    ac.enterS = nowS;
+    ac.leaveS = nowS + turnover / 2 + rng() % turnover;
+    return ac;
+}
+
+static void Move(SimAircraft& ac, double seconds)
+{
+    const double metres = ac.speedKts * 1852.0 / 3600.0 * seconds;
+    ac.lat += metres * std::cos(ac.track) / 111195.0;
+    ac.lon += metres * std::sin(ac.track) / (111195.0 * std::cos(ac.lat * M_PI / 180.0));
+}
+
+static double DistanceM(double lat1, double lon1, double lat2, double lon2)
+{
+    const double dy = (lat2 - lat1) * 111195.0;
+    const double dx = (lon2 - lon1) * 111195.0 * std::cos(lat1 * M_PI / 180.0);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned fleet = 80U;
+    unsigned seconds = 1800U;
+    unsigned turnover = 600U;
+    unsigned rate = 1U;
+    unsigned positionGap = 1U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--aircraft") == 0 && i + 1 < argc) {
+            fleet = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--turnover") == 0 && i + 1 < argc) {
+            turnover = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--position-gap") == 0 && i + 1 < argc) {
+            positionGap = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--aircraft N] [--seconds N] [--turnover N] [--rate N]"
+                    " [--position-gap N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (fleet == 0U || seconds == 0U || turnover == 0U || rate == 0U || rate > 100U ||
+        positionGap == 0U || positionGap > 60U) {
+        fprintf(stderr, "aircraft, seconds and turnover must be positive, rate 1 to 100, position gap 1 to 60\n");
+        return 2;
+    }
+
+    /* Every second each aircraft sends rate times an even and an odd
+     * position half a period apart (in every positionGap-th second only)
+     * and a velocity, and every 5 s its identification. */
+    std::mt19937 rng(seed);
+    std::vector<SimAircraft> aircraft;
+    uint32_t nextIcao = 0x3C0000U;
+    for (unsigned i = 0; i < fleet; i++) {
+        aircraft.push_back(NewAircraft(rng, nextIcao++, 0U, turnover));
+    }
+    std::vector<std::vector<ADS_BMessage>> schedule(seconds);
+    std::vector<std::vector<Truth>> truth(seconds);
+    std::vector<Departure> departures;
+    for (unsigned s = 0; s < seconds; s++) {
+        for (SimAircraft& ac : aircraft) {
+            if (s >= ac.leaveS) {
+                departures.push_back({ ac.icao, s - 1U, false });
+                ac = NewAircraft(rng, nextIcao++, s, turnover);
+            }
+            const uint32_t baseMs = s * 1000U;
+            const uint32_t halfMs = 500U / rate;
+            if (s % 5U == ac.icao % 5U) {
+                schedule[s].push_back(Identification(ac, baseMs));
+            }
+            const bool positions = (s % positionGap) == (ac.icao % positionGap);
+            for (unsigned r = 0; r < rate; r++) {
+                const uint32_t timeMs = baseMs + r * 2U * halfMs;
+                if (positions) {
+                    schedule[s].push_back(Position(ac, timeMs));
+                }
+                schedule[s].push_back(Velocity(ac, timeMs));
+                Move(ac, halfMs / 1000.0);
+                if (positions) {
+                    schedule[s].push_back(Position(ac, timeMs + halfMs));
+                }
+                Move(ac, halfMs / 1000.0);
+            }
+            Move(ac, (1000U - 2U * rate * halfMs) / 1000.0);
+            truth[s].push_back({ ac.icao, ac.lat, ac.lon });
+        }
+    }
+    size_t messages = 0;
+    for (const std::vector<ADS_BMessage>& second : schedule) {
+        messages += second.size();
+    }
+
+    SampleClock sampleClock;
+    sampleClock.SetSampleRate(ADS_B_SAMPLING);
+
+    /* Boot: from here on the model must not touch the heap. */
+    countAllocations = true;
+    FlightControl* model = new FlightControl();
+    FlightCotrolView view;
+    FlightControlControler controler(*model, view, sampleClock);
+    allocations = 0;
+
+    double messageSeconds = 0.0;
+    double tickSeconds = 0.0;
+    double viewSeconds = 0.0;
+    size_t peakTracked = 0;
+    double errorSum = 0.0;
+    double errorMax = 0.0;
+    size_t errorCount = 0;
+    unsigned errors = 0;
+    for (unsigned s = 0; s < seconds; s++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const ADS_BMessage& msg : schedule[s]) {
+            controler.PassNewMessage(msg);
+        }
+        /* The second's samples went by, the view shows its end. */
+        sampleClock.Advance(ADS_B_SAMPLING);
+        auto ticked = std::chrono::steady_clock::now();
+        controler.ExpireRecords();
+        auto viewed = std::chrono::steady_clock::now();
+        controler.UpdateView();
+        view.Refresh();
+        auto stop = std::chrono::steady_clock::now();
+        messageSeconds += std::chrono::duration<double>(ticked - start).count();
+        tickSeconds += std::chrono::duration<double>(viewed - ticked).count();
+        viewSeconds += std::chrono::duration<double>(stop - viewed).count();
+        peakTracked = std::max(peakTracked, model->GetAllRecords().Size());
+
+        for (const Truth& t : truth[s]) {
+            const AircraftRecord* record = model->FindAircraft(t.icao);
+            float lat, lon;
+            if (record != NULL && record->IsVelocityAndHeadingKnown() &&
+                record->GetPosition(view.GetTimeMs(), lat, lon)) {
+                const double error = DistanceM(t.lat, t.lon, lat, lon);
+                errorSum += error;
+                errorMax = std::max(errorMax, error);
+                errorCount++;
+            }
+        }
+
+        /* The last message of second lastS came before (lastS + 1) s, the
+         * view's time is (s + 1) s. */
+        const unsigned liveS = DEFAULT_LIVE_SPAN;
+        const unsigned fieldS = std::max(POSITION_TIMEOUT_MS, VELOCITY_TIMEOUT_MS) / 1000U;
+        for (Departure& d : departures) {
+            const AircraftRecord* record = model->FindAircraft(d.icao);
+            if (s == d.lastS) {
+                d.tracked = (record != NULL);
+            } else if (!d.tracked || s <= d.lastS) {
+                continue;
+            } else if (s + 1U < d.lastS + liveS && record == NULL) {
+                printf("  %06X expired %u s after it was last heard\n", d.icao, s - d.lastS);
+                errors++;
+                d.tracked = false;
+            } else if (s == d.lastS + fieldS + 2U && record != NULL &&
+                       (record->IsPositionKnown() || record->IsVelocityAndHeadingKnown())) {
+                printf("  %06X still shows position or velocity after %u s\n", d.icao, s - d.lastS);
+                errors++;
+            } else if (s >= d.lastS + liveS + 2U && record != NULL) {
+                printf("  %06X still tracked %u s after it was last heard\n", d.icao, s - d.lastS);
+                errors++;
+                d.tracked = false;
+            }
+        }
+    }
+    countAllocations = false;
+
+    /* Everything still in the air was heard during the last second, and
+     * has sent its identification and a position unless it only just
+     * appeared. */
+    unsigned untracked = 0;
+    for (const SimAircraft& ac : aircraft) {
+        if (ac.enterS + 10U + positionGap > seconds) {
+            continue;
+        }
+        AircraftRecord* record = model->FindAircraft(ac.icao);
+        /* With the table full, newcomers are dropped until records expire. */
+        if (record == NULL && peakTracked == MAX_AIRCRAFT) {
+            untracked++;
+            continue;
+        }
+        if (record == NULL || !record->IsPositionKnown() || !record->IsFlightNameKnown()) {
+            printf("  %06X not tracked\n", ac.icao);
+            errors++;
+            continue;
+        }
+        char callsign[9];
+        memcpy(callsign, ac.callsign, sizeof(callsign));
+        for (int i = 7; i >= 0 && callsign[i] == ' '; i--) {
+            callsign[i] = '\0';
+        }
+        float lat = 0.0F, lon = 0.0F;
+        record->GetPosition(view.GetTimeMs(), lat, lon);
+        const double error = DistanceM(ac.lat, ac.lon, lat, lon);
+        /* The strings must show the present numbers, however many updates
+         * they skipped. */
+        const char* position = record->GetPositionStr(view.GetTimeMs());
+        unsigned degrees = 0, minutes = 0, decimals = 0;
+        sscanf(position, "%u\xb0%u'%u", &degrees, &minutes, &decimals);
+        const double shownLat = degrees + minutes / 100.0 + decimals / 10000.0;
+        if (strncmp(record->GetFlightName(), callsign, strlen(callsign)) != 0 ||
+            error > MODEL_MAX_POSITION_ERROR_M ||
+            strtoul(record->GetAltitudeStr(), NULL, 10) != unsigned(ac.altitude) ||
+            std::fabs(shownLat - lat) > 0.0001) {
+            printf("  %s: '%s' at %s, %.0f m off\n", record->GetICAO_Address(), record->GetFlightName(),
+                   position, error);
+            errors++;
+        }
+    }
+
+    const double mhz = HostMHz();
+    printf("%u aircraft, %u s, %zu messages, %zu tracked at most, %zu at the end\n",
+           fleet, seconds, messages, peakTracked, model->GetAllRecords().Size());
+    if (untracked > 0U) {
+        printf("table full, %u aircraft in the air not tracked\n", untracked);
+    }
+    printf("controller  %7.1f ns/message", messageSeconds * 1e9 / messages);
+    if (mhz > 0.0) {
+        printf(", %6.0f cycles", messageSeconds * 1e6 * mhz / messages);
+    }
+    printf("\ntick        %7.1f us/tick\n", tickSeconds * 1e6 / seconds);
+    printf("view        %7.1f us/update\n", viewSeconds * 1e6 / seconds);
+    printf("total       %7.1f us per second of traffic\n",
+           (messageSeconds + tickSeconds + viewSeconds) * 1e6 / seconds);
+    printf("position    %7.1f m mean, %.1f m largest error shown\n",
+           errorCount ? errorSum / errorCount : 0.0, errorMax);
+    printf("model %zu bytes for %u aircraft, %zu per aircraft: %zu hot state, %zu record, %zu table index\n",
+           sizeof(FlightControl), MAX_AIRCRAFT, sizeof(FlightControl) / MAX_AIRCRAFT,
+           sizeof(AircraftState) / MAX_AIRCRAFT, sizeof(AircraftRecord),
+           (sizeof(AircraftTable) - sizeof(AircraftRecord) * MAX_AIRCRAFT) / MAX_AIRCRAFT);
+    printf("heap allocations after boot: %zu\n", allocations);
+    printf("%s\n", (errors == 0 && allocations == 0) ? "ok" : "FAILED");
+    delete model;
+    return (errors == 0 && allocations == 0) ? 0 : 1;
+}
@@ -0,0 +1,576 @@
+/*
+ * ReplayBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Streams a raw 8 bit rtl-sdr capture through ADS_BDecoder in
+ * USB_IN_STREAM_SIZE chunks, exactly as RTLSDRDataAquisitionTask does on the
+ * board, and reports decoder throughput per processing stage.
+ *
+ * Both the streaming and the per buffer demodulation modes are replayed by
+ * default so the effect of carrying history across buffers is visible.
+ * Before replaying, the compile time magnitude tables are checked against
+ * round(sqrt(i*i+q*q)*360) and the decoder footprint is printed. The
+ * message bus is drained in batches after every buffer (every N buffers
+ * with --drain-every N, to model a slow consumer) and the fields the
+ * controller uses are extracted from the messages, timed separately from
+ * the decoder, and their signal levels summarised.
+ *
+ * --drop-every N leaves out every Nth buffer, as an overrun of the USB ring
+ * would, and stamps the others with the capture time the driver would give
+ * them. The sample clock has to skip the dropped samples: every buffer
+ * must start at its true offset in the capture, otherwise the replay
+ * fails.
+ *
+ * usage: ReplayBenchmark <capture.iq> [--loops N] [--mode streaming|buffer|both]
+ *                        [--kernel lut|rawiq|simd32|ambm|sse2|avx2]
+ *                        [--correction 0|1|2] [--crc reference|table|hardware]
+ *                        [--prefilter on|off|compare] [--rate 2000000|2400000]
+ *                        [--demod classic|multiphase|compare]
+ *                        [--policy oldest|newest|positions] [--drain-every N]
+ *                        [--drop-every N]
+ *
+ * With --prefilter compare every mode is replayed with and without the
+ * preamble prefilter and the saved full checks and detect time are printed.
+ * --rate gives the sample rate of the capture (ADS_B_SAMPLING by default),
+ * --demod compare replays a 2 MS/s capture with both demodulators and prints
+ * the decode yield against the detect time. */
+
+#include "ADSBDecoder.h"
+#include "ADSBMessage.h"
+#include "CycleCounter.h"
+#include "HostClock.h"
+#include "IQCapture.h"
+#include "MagnitudeLUT.h"
+#include "cmsis_os.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct ReplayOptions
+{
+	bool streaming;
+	bool prefilter;
+	const MagnitudeKernel* kernel;
+	CrcCorrection correction;
+	const CrcEngine* crc;
+	uint32_t sampleRate;
+	DemodulatorType demodulator;
+	MessageDropPolicy dropPolicy;
+	unsigned drainEvery;
+	unsigned dropEvery;
+};
+
+struct ReplayResult
+{
+	ADS_BDecoderStats stats;
+	double wallSeconds;
+	uint64_t messages;
+	uint64_t messagesCrcOk;
+	MessageBusStats bus;
+	uint32_t sampleRate;
+	uint64_t consumerTicks;
+	double signalPower;         /* Sum of signalLevel^2 of the crc ok messages. */
+	uint16_t signalMin;
+	uint16_t signalMax;
+	SampleClockStats clock;
+	uint64_t clockError;        /* Largest error of a buffer start, in samples. */
+};
+
+/* What FlightControlControler::UpdateRecord pulls out of a message. */
+static volatile int fieldSink;
+
+static void ExtractFields(const ADS_BMessage& msg)
+{
+	if(msg.msgtype != 17)
+	{
+		return;
+	}
+	if(msg.IsIdentification())
+	{
+		char flight[9];
+		msg.Flight(flight);
+		fieldSink = flight[0];
+	}
+	else if(msg.IsAirbornePosition())
+	{
+		int unit;
+		fieldSink = msg.Altitude(&unit) + msg.CprOdd() + msg.RawLatitude() + msg.RawLongitude();
+	}
+	else if(msg.IsAirborneVelocity())
+	{
+		fieldSink = msg.Velocity() + int(msg.Heading());
+	}
+}
+
+static void DrainBus(MessageBus& messageBus, ReplayResult& result)
+{
+	ADS_BMessage batch[MESSAGE_BUS_BATCH];
+	size_t count;
+	while((count = messageBus.Drain(batch, MESSAGE_BUS_BATCH)) > 0U)
+	{
+		for(size_t i = 0U; i < count; i++)
+		{
+			result.messages++;
+			if(batch[i].CrcOk())
+			{
+				result.messagesCrcOk++;
+				const uint16_t level = batch[i].signalLevel;
+				result.signalPower += double(level) * level;
+				result.signalMin = (level < result.signalMin) ? level : result.signalMin;
+				result.signalMax = (level > result.signalMax) ? level : result.signalMax;
+				uint32_t extractStart = CycleCounterNow();
+				ExtractFields(batch[i]);
+				result.consumerTicks += CycleCounterNow() - extractStart;
+			}
+		}
+	}
+}
+
+static ReplayResult Replay(const IQCapture& capture, size_t buffers, unsigned loops, const ReplayOptions& options)
+{
+	ReplayResult result;
+	MessageBus* messageBus = new MessageBus();
+	messageBus->SetDropPolicy(options.dropPolicy);
+	SampleClock* sampleClock = new SampleClock();
+	ADS_BDecoder* decoder = new ADS_BDecoder(*messageBus, *sampleClock);
+	decoder->SetStreamingMode(options.streaming);
+	decoder->SetPreambleFilter(options.prefilter);
+	decoder->SetCrcCorrection(options.correction);
+	decoder->SetCrcEngine(options.crc->type);
+	decoder->SetMagnitudeKernel(options.kernel->type);
+	decoder->SetSampleRate(options.sampleRate);
+	decoder->SetDemodulator(options.demodulator);
+
+	result.messages = 0U;
+	result.messagesCrcOk = 0U;
+	result.consumerTicks = 0U;
+	result.signalPower = 0.0;
+	result.signalMin = UINT16_MAX;
+	result.signalMax = 0U;
+	result.clockError = 0U;
+	bool afterGap = false;
+	auto start = std::chrono::steady_clock::now();
+	for(unsigned loop = 0U; loop < loops; loop++)
+	{
+		const uint8_t* raw = capture.Data();
+		decoder->ResetStream();
+		for(size_t b = 0U; b < buffers; b++, raw += USB_IN_STREAM_SIZE)
+		{
+			/* Samples captured up to the end of this buffer. */
+			const uint64_t end = (uint64_t(loop) * buffers + b + 1U) * MODES_MAGNITUDE_SAMPLES;
+			if(options.dropEvery == 0U)
+			{
+				decoder->ProcessRawSamples(raw);
+			}
+			else if((end / MODES_MAGNITUDE_SAMPLES) % options.dropEvery == 0U)
+			{
+				afterGap = true;
+			}
+			else
+			{
+				SampleBufferTime time;
+				time.cycles = uint32_t(end * CycleCounterFrequency() / options.sampleRate);
+				time.tick = uint32_t(end * configTICK_RATE_HZ / options.sampleRate);
+				time.afterGap = afterGap;
+				afterGap = false;
+				decoder->ProcessRawSamples(raw, time);
+				const uint64_t next = sampleClock->GetNext();
+				const uint64_t error = next > end ? next - end : end - next;
+				if(error > result.clockError)
+				{
+					result.clockError = error;
+				}
+			}
+			if((b + 1U) % options.drainEvery == 0U || b + 1U == buffers)
+			{
+				DrainBus(*messageBus, result);
+			}
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	result.stats = decoder->GetStats();
+	result.wallSeconds = std::chrono::duration<double>(stop - start).count();
+	result.bus = messageBus->GetStats();
+	result.sampleRate = decoder->GetSampleRate();
+	result.clock = sampleClock->GetStats();
+
+	delete decoder;
+	delete sampleClock;
+	delete messageBus;
+	return result;
+}
+
+static void Report(const char* title, const ReplayResult& r)
+{
+	const ADS_BDecoderStats& stats = r.stats;
+	const double samples = double(stats.buffers) * (USB_IN_STREAM_SIZE / 2);
+	const double airSeconds = samples / r.sampleRate;
+	const double tickNs = 1e9 / CycleCounterFrequency();
+	const double perBuffer = stats.buffers ? tickNs / stats.buffers : 0.0;
+
+	printf("[%s]\n", title);
+	printf("samples          : %.0f (%.3f s of air time)\n", samples, airSeconds);
+	printf("wall time        : %.3f s (%.1fx real time)\n", r.wallSeconds, airSeconds / r.wallSeconds);
+	printf("preambles        : %lu (%lu full checks, %.1f per buffer)\n", (unsigned long)stats.preambles,
+		   (unsigned long)stats.preambleChecks, stats.buffers ? double(stats.preambleChecks) / stats.buffers : 0.0);
+	printf("early rejects    : %lu (%.1f%% of preambles)\n", (unsigned long)stats.earlyRejects,
+		   stats.preambles ? 100.0 * stats.earlyRejects / stats.preambles : 0.0);
+	printf("frames decoded   : %lu (%lu crc ok, %lu across buffer seams)\n",
+		   (unsigned long)stats.frames, (unsigned long)stats.framesCrcOk,
+		   (unsigned long)stats.framesAcrossSeam);
+	printf("crc corrections  : %lu one bit, %lu two bits\n",
+		   (unsigned long)stats.framesFixedOneBit, (unsigned long)stats.framesFixedTwoBits);
+	printf("off phase frames : %lu\n", (unsigned long)stats.framesOffPhase);
+	printf("messages queued  : %lu (%lu crc ok, bus high water %lu)\n",
+		   (unsigned long)r.messages, (unsigned long)r.messagesCrcOk, (unsigned long)r.bus.highWater);
+	printf("bus              : %lu batches, %lu dropped newest, %lu dropped oldest, max lag %.1f us\n",
+		   (unsigned long)r.bus.batches, (unsigned long)r.bus.droppedNewest,
+		   (unsigned long)r.bus.droppedOldest, r.bus.maxLagTicks * tickNs / 1000.0);
+	if(r.messagesCrcOk > 0U)
+	{
+		printf("signal level     : min %.1f, mean %.1f, max %.1f dBFS\n", SignalLevelDbfs(r.signalMin),
+			   SignalLevelDbfs(sqrt(r.signalPower / r.messagesCrcOk)), SignalLevelDbfs(r.signalMax));
+	}
+	printf("msgs/s           : %.1f wall, %.1f air\n", r.messagesCrcOk / r.wallSeconds, r.messagesCrcOk / airSeconds);
+	printf("samples/s        : %.3e\n", samples / r.wallSeconds);
+	printf("ns/buffer        : magnitude %.1f, detect %.1f, decode %.1f, total %.1f\n",
+		   stats.magnitudeTicks * perBuffer,
+		   (stats.detectTicks - stats.decodeTicks) * perBuffer,
+		   stats.decodeTicks * perBuffer,
+		   (stats.magnitudeTicks + stats.detectTicks) * perBuffer);
+	printf("ns/frame decode  : %.1f\n", stats.frames ? stats.decodeTicks * tickNs / stats.frames : 0.0);
+	printf("ns/msg fields    : %.1f (consumer side accessors)\n",
+		   r.messagesCrcOk ? r.consumerTicks * tickNs / r.messagesCrcOk : 0.0);
+	printf("ns/buffer filter : %.1f (part of detect)\n", stats.prefilterTicks * perBuffer);
+	printf("ns/preamble slice: %.1f (%.1f per buffer, part of detect)\n",
+		   stats.preambles ? stats.sliceTicks * tickNs / stats.preambles : 0.0, stats.sliceTicks * perBuffer);
+}
+
+static void ReportPrefilterGain(const ReplayResult& on, const ReplayResult& off)
+{
+	const double tickNs = 1e9 / CycleCounterFrequency();
+	const double mhz = HostMHz();
+	const double checksOn = double(on.stats.preambleChecks) / on.stats.buffers;
+	const double checksOff = double(off.stats.preambleChecks) / off.stats.buffers;
+	const double detectOn = (on.stats.detectTicks - on.stats.decodeTicks) * tickNs / on.stats.buffers;
+	const double detectOff = (off.stats.detectTicks - off.stats.decodeTicks) * tickNs / off.stats.buffers;
+
+	printf("prefilter gain   : full checks %.1f -> %.1f per buffer (%.1f%% fewer), messages %s\n",
+		   checksOff, checksOn, 100.0 * (1.0 - checksOn / checksOff),
+		   on.messagesCrcOk == off.messagesCrcOk ? "identical" : "DIFFER");
+	printf("                   detect %.1f -> %.1f ns/buffer, %.1f ns (%.0f cycles) saved per buffer\n",
+		   detectOff, detectOn, detectOff - detectOn, (detectOff - detectOn) * mhz / 1e3);
+}
+
+static void ReportDemodulatorGain(const ReplayResult& classic, const ReplayResult& multiPhase)
+{
+	const double tickNs = 1e9 / CycleCounterFrequency();
+	const double detectClassic = (classic.stats.detectTicks - classic.stats.decodeTicks) * tickNs / classic.stats.buffers;
+	const double detectMulti = (multiPhase.stats.detectTicks - multiPhase.stats.decodeTicks) * tickNs / multiPhase.stats.buffers;
+
+	printf("multi-phase gain : crc ok messages %lu -> %lu (%+.1f%%)\n",
+		   (unsigned long)classic.messagesCrcOk, (unsigned long)multiPhase.messagesCrcOk,
+		   classic.messagesCrcOk ? 100.0 * (double(multiPhase.messagesCrcOk) / classic.messagesCrcOk - 1.0) : 0.0);
+	printf("                   detect %.1f -> %.1f ns/buffer (%+.1f%%)\n",
+		   detectClassic, detectMulti, 100.0 * (detectMulti / detectClassic - 1.0));
+}
+
+static bool CheckMagnitudeLUT()
+{
+	for(int i = 0; i < MAGNITUDE_LUT_SIDE; i++)
+	{
+		for(int q = 0; q < MAGNITUDE_LUT_SIDE; q++)
+		{
+			const uint16_t expected = uint16_t(round(sqrt(i*i+q*q)*MAGNITUDE_SCALE));
+			if(magnitudeLUT.value[i*MAGNITUDE_LUT_SIDE+q] != expected)
+			{
+				fprintf(stderr, "magnitude table mismatch at i=%d q=%d\n", i, q);
+				return false;
+			}
+		}
+	}
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+	for(int iq = 0; iq < MAGNITUDE_RAW_IQ_LUT_SIZE; iq++)
+	{
+		const int i = abs((iq & 0xFF) - 127);
+		const int q = abs((iq >> 8) - 127);
+		if(magnitudeRawIQLUT.value[iq] != magnitudeLUT.value[i*MAGNITUDE_LUT_SIDE+q])
+		{
+			fprintf(stderr, "raw I/Q magnitude table mismatch at 0x%04x\n", iq);
+			return false;
+		}
+	}
+#endif
+	return true;
+}
+
+static void ReportFootprint()
+{
+	MessageBus* messageBus = new MessageBus();
+	SampleClock* sampleClock = new SampleClock();
+	auto start = std::chrono::steady_clock::now();
+	ADS_BDecoder* decoder = new ADS_BDecoder(*messageBus, *sampleClock);
+	auto stop = std::chrono::steady_clock::now();
+
+	size_t lutBytes = sizeof(magnitudeLUT) + sizeof(magnitude8LUT) + sizeof(magnitudeSquaredLUT);
+#if defined(MAGNITUDE_RAW_IQ_LUT)
+	lutBytes += sizeof(magnitudeRawIQLUT);
+#endif
+	printf("magnitude tables : %zu bytes read only\n", lutBytes);
+	printf("decoder object   : %zu bytes, constructed in %.1f us\n", sizeof(ADS_BDecoder),
+		   std::chrono::duration<double, std::micro>(stop - start).count());
+	printf("message record   : %zu bytes, message bus %zu bytes for %d messages\n", sizeof(ADS_BMessage),
+		   sizeof(MessageBus), MESSAGE_BUS_CAPACITY);
+
+	delete decoder;
+	delete sampleClock;
+	delete messageBus;
+}
+
+static void PrintUsage(const char* name)
+{
+	fprintf(stderr, "usage: %s <capture.iq> [--loops N] [--mode streaming|buffer|both]"
+			" [--kernel lut|rawiq|simd32|ambm|sse2|avx2] [--correction 0|1|2]"
+			" [--crc reference|table|hardware] [--prefilter on|off|compare]"
+			" [--rate 2000000|2400000] [--demod classic|multiphase|compare]"
+			" [--policy oldest|newest|positions] [--drain-every N] [--drop-every N]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+	const char* path = NULL;
+	unsigned loops = 1U;
+	bool runBuffer = true;
+	bool runStreaming = true;
+	bool comparePrefilter = false;
+	bool compareDemodulator = false;
+	bool classicOnly = false;
+	ReplayOptions options;
+	options.streaming = true;
+	options.prefilter = true;
+	options.kernel = GetDefaultMagnitudeKernel();
+	options.correction = CrcCorrectionSingleBit;
+	options.crc = GetCrcEngine(CrcTableEngine);
+	options.sampleRate = ADS_B_SAMPLING;
+	options.demodulator = (ADS_B_SAMPLING == MODES_SAMPLING_2000K) ? ClassicDemodulator : MultiPhaseDemodulator;
+	options.dropPolicy = DropOldest;
+	options.drainEvery = 1U;
+	options.dropEvery = 0U;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+		{
+			loops = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "--mode") == 0 && i + 1 < argc)
+		{
+			const char* mode = argv[++i];
+			runBuffer = strcmp(mode, "streaming") != 0;
+			runStreaming = strcmp(mode, "buffer") != 0;
+		}
+		else if(strcmp(argv[i], "--kernel") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			options.kernel = NULL;
+			for(int type = 0; type < MagnitudeKernelCount; type++)
+			{
+				const MagnitudeKernel* candidate = GetMagnitudeKernel(MagnitudeKernelType(type));
+				if(candidate != NULL && strcmp(candidate->name, name) == 0)
+				{
+					options.kernel = candidate;
+				}
+			}
+			if(options.kernel == NULL)
+			{
+				fprintf(stderr, "magnitude kernel %s is not available\n", name);
+				return 2;
+			}
+		}
+		else if(strcmp(argv[i], "--crc") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			options.crc = NULL;
+			for(int type = 0; type < CrcEngineCount; type++)
+			{
+				const CrcEngine* candidate = GetCrcEngine(CrcEngineType(type));
+				if(candidate != NULL && strcmp(candidate->name, name) == 0)
+				{
+					options.crc = candidate;
+				}
+			}
+			if(options.crc == NULL)
+			{
+				fprintf(stderr, "crc engine %s is not available\n", name);
+				return 2;
+			}
+		}
+		else if(strcmp(argv[i], "--correction") == 0 && i + 1 < argc)
+		{
+			options.correction = CrcCorrection(strtoul(argv[++i], NULL, 0));
+			if(options.correction > CrcCorrectionTwoBits)
+			{
+				PrintUsage(argv[0]);
+				return 2;
+			}
+		}
+		else if(strcmp(argv[i], "--prefilter") == 0 && i + 1 < argc)
+		{
+			const char* mode = argv[++i];
+			options.prefilter = strcmp(mode, "off") != 0;
+			comparePrefilter = strcmp(mode, "compare") == 0;
+		}
+		else if(strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+		{
+			options.sampleRate = strtoul(argv[++i], NULL, 0);
+			if(GetDemodTable(options.sampleRate) == NULL)
+			{
+				fprintf(stderr, "sample rate %lu is not supported\n", (unsigned long)options.sampleRate);
+				return 2;
+			}
+		}
+		else if(strcmp(argv[i], "--demod") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			classicOnly = strcmp(name, "classic") == 0;
+			compareDemodulator = strcmp(name, "compare") == 0;
+			options.demodulator = strcmp(name, "multiphase") == 0 ? MultiPhaseDemodulator : ClassicDemodulator;
+			if(classicOnly == false && compareDemodulator == false && options.demodulator == ClassicDemodulator)
+			{
+				PrintUsage(argv[0]);
+				return 2;
+			}
+		}
+		else if(strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+		{
+			static const char* const policies[MessageDropPolicyCount] = { "oldest", "newest", "positions" };
+			const char* name = argv[++i];
+			int p;
+			for(p = 0; p < MessageDropPolicyCount && strcmp(policies[p], name) != 0; p++)
+			{
+			}
+			if(p == MessageDropPolicyCount)
+			{
+				PrintUsage(argv[0]);
+				return 2;
+			}
+			options.dropPolicy = MessageDropPolicy(p);
+		}
+		else if(strcmp(argv[i], "--drain-every") == 0 && i + 1 < argc)
+		{
+			options.drainEvery = strtoul(argv[++i], NULL, 0);
+		}
+		else if(strcmp(argv[i], "--drop-every") == 0 && i + 1 < argc)
+		{
+			options.dropEvery = strtoul(argv[++i], NULL, 0);
+			if(options.dropEvery == 1U)
+			{
+				PrintUsage(argv[0]);
+				return 2;
+			}
+		}
+		else if(path == NULL && argv[i][0] != '-')
+		{
+			path = argv[i];
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return 2;
+		}
+	}
+	if(path == NULL || loops == 0U || options.drainEvery == 0U)
+	{
+		PrintUsage(argv[0]);
+		return 2;
+	}
+
+	if(CheckMagnitudeLUT() == false)
+	{
+		return 1;
+	}
+	ReportFootprint();
+
+	IQCapture capture;
+	if(capture.Open(path) == false)
+	{
+		fprintf(stderr, "cannot map %s\n", path);
+		return 1;
+	}
+
+	const size_t buffers = capture.Size() / USB_IN_STREAM_SIZE;
+	if(buffers == 0U)
+	{
+		fprintf(stderr, "%s is shorter than one USB buffer\n", path);
+		return 1;
+	}
+	printf("capture          : %s (%zu buffers x %u loops)\n", path, buffers, loops);
+	printf("magnitude kernel : %s\n", options.kernel->name);
+	printf("crc              : %s engine, correction %d bit(s)\n", options.crc->name, int(options.correction));
+	printf("preamble filter  : %s\n", options.prefilter ? "on" : "off");
+	if(options.sampleRate != MODES_SAMPLING_2000K)
+	{
+		if(classicOnly || compareDemodulator)
+		{
+			fprintf(stderr, "the classic demodulator only supports 2000000 S/s\n");
+			return 2;
+		}
+		options.demodulator = MultiPhaseDemodulator;
+	}
+	printf("demodulator      : %s at %.1f MS/s\n",
+		   options.demodulator == ClassicDemodulator ? "classic" : "multi-phase", options.sampleRate / 1e6);
+
+	bool clockOk = true;
+	ReplayResult perBuffer, streaming;
+	for(int mode = 0; mode < 2; mode++)
+	{
+		if((mode == 0 && runBuffer == false) || (mode == 1 && runStreaming == false))
+		{
+			continue;
+		}
+		options.streaming = (mode == 1);
+		ReplayResult& result = options.streaming ? streaming : perBuffer;
+		result = Replay(capture, buffers, loops, options);
+		Report(options.streaming ? "streaming" : "per buffer", result);
+		if(options.dropEvery != 0U)
+		{
+			printf("sample clock     : %lu gaps, %llu samples skipped, epoch %u, max error %llu samples\n",
+				   (unsigned long)result.clock.gaps, (unsigned long long)result.clock.samplesLost,
+				   unsigned(result.clock.gaps & 0xFF), (unsigned long long)result.clockError);
+			clockOk = clockOk && result.clockError == 0U;
+		}
+		if(comparePrefilter)
+		{
+			ReplayOptions unfiltered = options;
+			unfiltered.prefilter = false;
+			ReportPrefilterGain(result, Replay(capture, buffers, loops, unfiltered));
+		}
+		if(compareDemodulator)
+		{
+			ReplayOptions multiPhase = options;
+			multiPhase.demodulator = MultiPhaseDemodulator;
+			ReplayResult other = Replay(capture, buffers, loops, multiPhase);
+			Report(options.streaming ? "streaming, multi-phase" : "per buffer, multi-phase", other);
+			ReportDemodulatorGain(result, other);
+		}
+	}
+	if(runBuffer && runStreaming && perBuffer.messagesCrcOk > 0U)
+	{
+		const double airSeconds = double(streaming.stats.buffers) * (USB_IN_STREAM_SIZE / 2) / options.sampleRate;
+		printf("streaming gain   : %+.1f msgs/s air (%+.1f%%)\n",
+			   (double(streaming.messagesCrcOk) - double(perBuffer.messagesCrcOk)) / airSeconds,
+			   100.0 * (double(streaming.messagesCrcOk) / double(perBuffer.messagesCrcOk) - 1.0));
+	}
+	if(clockOk == false)
+	{
+		fprintf(stderr, "sample clock lost track of the capture over dropped buffers\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * SampleClockTest.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Checks SampleClock::Now() while no buffers arrive, as when the dongle
+ * stalls or is unplugged. The host time is set by hand: one buffer anchors
+ * the clock right before the 32 bit cycle counter wraps, then time steps
+ * on for --seconds without another buffer, past several wraps. Now() must
+ * stay within a tick of the time that went by and never go back. A record
+ * heard in the anchored buffer must still be there before the live span
+ * and expire after it. Exits with 1 on any failure.
+ *
+ * usage: SampleClockTest [--seconds N] [--step-ms N] */
+
+#include "CycleCounter.h"
+#include "FlightControlControler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define TEST_ICAO 0x4CA2D6U
+
+static unsigned failures;
+
+static void Check(bool ok, const char* what, double seconds)
+{
+    if (!ok && failures++ < 10U) {
+        printf("  FAILED at %.3f s: %s\n", seconds, what);
+    }
+}
+
+static ADS_BMessage Velocity(uint64_t timestamp)
+{
+    ADS_BMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.SetTimestamp(timestamp);
+    msg.signalLevel = 2000;
+    msg.msgtype = 17;
+    msg.longFrame = 1;
+    msg.crcStatus = CrcStatusOk;
+    msg.msg[0] = (17 << 3) | 5;
+    msg.msg[1] = (TEST_ICAO >> 16) & 0xFF;
+    msg.msg[2] = (TEST_ICAO >> 8) & 0xFF;
+    msg.msg[3] = TEST_ICAO & 0xFF;
+    /* 100 kt east, 0 kt north. */
+    msg.msg[4] = (19 << 3) | 1;
+    msg.msg[6] = 101;
+    msg.msg[7] = 0;
+    msg.msg[8] = 1 << 5;
+    msg.msg[9] = 1 << 2;
+    return msg;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned seconds = 150U;
+    unsigned stepMs = 250U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--step-ms") == 0 && i + 1 < argc) {
+            stepMs = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--step-ms N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (stepMs == 0U) {
+        fprintf(stderr, "step-ms must be positive\n");
+        return 2;
+    }
+
+    SampleClock sampleClock;
+    sampleClock.SetSampleRate(ADS_B_SAMPLING);
+    FlightControl* model = new FlightControl();
+    FlightCotrolView* view = new FlightCotrolView();
+    FlightControlControler controler(*model, *view, sampleClock);
+    const uint32_t liveMs = model->GetTimeouts().recordMs;
+
+    /* Half a second before the cycle counter wraps. */
+    const uint64_t startNs = (uint64_t(1000) << 32) - 500000000U;
+    HostTimeSet(startNs);
+    SampleBufferTime time;
+    time.cycles = CycleCounterNow();
+    time.tick = xTaskGetTickCount();
+    time.afterGap = false;
+    const uint64_t first = sampleClock.Advance(USB_IN_STREAM_SIZE / 2, time);
+    const uint64_t anchor = sampleClock.GetNext();
+    controler.PassNewMessage(Velocity(first));
+    controler.ExpireRecords();
+
+    const double rate = sampleClock.GetSampleRate();
+    const double tolerance = rate / configTICK_RATE_HZ + 1.0;
+    uint64_t last = sampleClock.Now();
+    double worst = 0.0;
+    bool expired = false;
+    for (uint64_t ms = stepMs; ms <= uint64_t(seconds) * 1000U; ms += stepMs) {
+        HostTimeSet(startNs + ms * 1000000U);
+        const double s = ms / 1000.0;
+        const uint64_t now = sampleClock.Now();
+        const double error = std::fabs(double(now) - double(anchor) - s * rate);
+        worst = std::max(worst, error);
+        Check(error <= tolerance, "Now() is off the elapsed time", s);
+        Check(now >= last, "Now() went back", s);
+        last = now;
+
+        controler.ExpireRecords();
+        const bool tracked = model->GetAllRecords().Size() != 0U;
+        if (ms + 1000U < liveMs) {
+            Check(tracked, "record expired before the live span", s);
+        } else if (ms > liveMs + 2000U) {
+            Check(!tracked, "record outlived the live span", s);
+            expired = expired || !tracked;
+        }
+    }
+    if (uint64_t(seconds) * 1000U > liveMs + 2000U) {
+        Check(expired, "record never expired", seconds);
+    }
+
+    printf("%u s without buffers, %.2f cycle counter wraps, worst error %.1f samples (tolerance %.1f)\n",
+           seconds, seconds * double(CycleCounterFrequency()) / 4294967296.0, worst, tolerance);
+    printf("%s\n", failures ? "FAILED" : "ok");
+    delete view;
+    delete model;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * SnapshotStress.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Stress test of the snapshot handoff from the controller task to the GUI
+ * task. One thread runs FlightControlControler as FlightControlerTask
+ * does: a position squitter from every aircraft, the tick and a published
+ * snapshot per simulated second, as fast as it can. A second thread is the
+ * GUI task, refreshing the host view in a loop and checking every snapshot
+ * it gets:
+ *  - versions only go up,
+ *  - every aircraft is listed in slot order with its own address,
+ *  - every altitude is the one all aircraft sent in the snapshot's second,
+ *    so a snapshot written while it was read would show mixed altitudes,
+ *  - every string is terminated within its field.
+ * At the end the GUI must see the last snapshot. The tool exits with 1 on
+ * any failure.
+ *
+ * Build with -DSTRATOS_SANITIZE_THREAD=ON to run it under ThreadSanitizer,
+ * which then also reports any access to a snapshot that is not ordered by
+ * the handoff.
+ *
+ * usage: SnapshotStress [--steps N] [--aircraft N] */
+
+#include "CprReference.h"
+#include "FlightControlControler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#define STRESS_ICAO_BASE 0x400000U
+#define STRESS_LAT 51.109402
+#define STRESS_LON 17.059798
+
+/* What all aircraft report in second s. */
+static uint32_t AltitudeAt(uint32_t s)
+{
+    return 1000U + 25U * (s % 1900U);
+}
+
+static ADS_BMessage Position(uint32_t icao, uint32_t s, uint32_t timeMs)
+{
+    ADS_BMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.SetTimestamp(uint64_t(timeMs) * ADS_B_SAMPLING / 1000U);
+    msg.signalLevel = 2000;
+    msg.msgtype = 17;
+    msg.longFrame = 1;
+    msg.crcStatus = CrcStatusOk;
+    msg.msg[0] = (17 << 3) | 5;
+    msg.msg[1] = icao >> 16;
+    msg.msg[2] = icao >> 8;
+    msg.msg[3] = icao;
+    const bool odd = s & 1U;
+    int yz, xz;
+    CprEncode(STRESS_LAT + (icao & 0xFF) * 0.001, STRESS_LON, odd, yz, xz);
+    const int n = (AltitudeAt(s) + 1000) / 25;
+    msg.msg[4] = (11 << 3);
+    msg.msg[5] = ((n >> 4) << 1) | 1;
+    msg.msg[6] = ((n & 15) << 4) | (odd << 2) | ((yz >> 15) & 3);
+    msg.msg[7] = (yz >> 7) & 0xFF;
+    msg.msg[8] = ((yz & 0x7F) << 1) | ((xz >> 16) & 1);
+    msg.msg[9] = (xz >> 8) & 0xFF;
+    msg.msg[10] = xz & 0xFF;
+    return msg;
+}
+
+static bool Terminated(const char* field, size_t size)
+{
+    return memchr(field, '\0', size) != NULL;
+}
+
+/* Problems with one snapshot, printing the first few. */
+static unsigned Check(const AircraftSnapshot& snapshot, uint32_t lastVersion, unsigned fleet, unsigned& reported)
+{
+    unsigned errors = 0;
+    auto fail = [&](const char* what, unsigned index) {
+        if (reported++ < 10U) {
+            printf("  snapshot %lu: %s (aircraft %u)\n", (unsigned long)snapshot.version, what, index);
+        }
+        errors++;
+    };
+    if (snapshot.version <= lastVersion) {
+        fail("version did not go up", 0U);
+    }
+    /* Every aircraft is in from the first second on. */
+    if (snapshot.count != fleet) {
+        fail("wrong number of aircraft", snapshot.count);
+        return errors;
+    }
+    const uint32_t s = snapshot.timeMs / 1000U - 1U;
+    for (unsigned i = 0; i < snapshot.count; i++) {
+        const AircraftSnapshotEntry& aircraft = snapshot.aircraft[i];
+        if (!Terminated(aircraft.icaoStr, ICAO_STR_SIZE) || !Terminated(aircraft.flightName, FLIGHT_NAME_SIZE) ||
+            !Terminated(aircraft.altitudeStr, ALTITUDE_STR_SIZE) ||
+            !Terminated(aircraft.positionStr, POSITION_STR_SIZE) ||
+            !Terminated(aircraft.velocityStr, VELOCITY_STR_SIZE) ||
+            !Terminated(aircraft.headingStr, HEADING_STR_SIZE)) {
+            fail("unterminated string", i);
+        } else if (strtoul(aircraft.icaoStr, NULL, 16) != STRESS_ICAO_BASE + i) {
+            fail("wrong address", i);
+        } else if ((aircraft.known & AircraftAltitude) == 0U ||
+                   strtoul(aircraft.altitudeStr, NULL, 10) != AltitudeAt(s)) {
+            fail("altitude of another second", i);
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned steps = 20000U;
+    unsigned fleet = MAX_AIRCRAFT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--aircraft") == 0 && i + 1 < argc) {
+            fleet = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--steps N] [--aircraft N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (steps == 0U || fleet == 0U || fleet > MAX_AIRCRAFT) {
+        fprintf(stderr, "steps must be positive, aircraft 1 to %u\n", MAX_AIRCRAFT);
+        return 2;
+    }
+
+    SampleClock sampleClock;
+    sampleClock.SetSampleRate(ADS_B_SAMPLING);
+    FlightControl* model = new FlightControl();
+    FlightCotrolView* view = new FlightCotrolView();
+    FlightControlControler controler(*model, *view, sampleClock);
+
+    std::atomic<bool> done(false);
+    unsigned errors = 0;
+    unsigned reported = 0;
+    unsigned seen = 0;
+    uint32_t lastVersion = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread gui([&]() {
+        /* One more look after the controller stopped. */
+        bool last = false;
+        while (!last) {
+            last = done.load(std::memory_order_acquire);
+            if (view->Refresh()) {
+                const AircraftSnapshot& snapshot = view->GetSnapshot();
+                errors += Check(snapshot, lastVersion, fleet, reported);
+                lastVersion = snapshot.version;
+                seen++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (uint32_t s = 0; s < steps; s++) {
+        for (unsigned i = 0; i < fleet; i++) {
+            controler.PassNewMessage(Position(STRESS_ICAO_BASE + i, s, s * 1000U + i));
+        }
+        sampleClock.Advance(ADS_B_SAMPLING);
+        controler.ExpireRecords();
+        controler.UpdateView();
+    }
+    done.store(true, std::memory_order_release);
+    gui.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (lastVersion != steps) {
+        printf("  the GUI ended on snapshot %lu of %u\n", (unsigned long)lastVersion, steps);
+        errors++;
+    }
+    printf("%u aircraft, %u snapshots published, %u seen by the GUI, %.1f us per snapshot\n",
+           fleet, steps, seen, seconds * 1e6 / steps);
+    printf("snapshot %zu bytes, %zu per aircraft, %zu for the three buffers\n",
+           sizeof(AircraftSnapshot), sizeof(AircraftSnapshotEntry), sizeof(AircraftSnapshots));
+    printf("%s\n", errors ? "FAILED" : "ok");
+    delete view;
+    delete model;
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * SpscRingBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Stress test and throughput benchmark of SpscRing. A producer thread and
+ * a consumer thread move a numbered stream through the ring with single,
+ * bulk and in place (acquire/commit) operations; the consumer checks that
+ * every number arrives exactly once and in order. Each access mode is then
+ * timed on its own. The stress pass randomises the batch sizes and mixes
+ * the access modes on both sides, with the same seed giving the same mix.
+ *
+ * usage: SpscRingBenchmark [--items N] [--seed N] */
+
+#include "SpscRing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#define RING_SIZE 256
+#define MAX_BATCH 64
+
+typedef SpscRing<uint32_t, RING_SIZE> Ring;
+
+enum AccessMode
+{
+    SingleAccess = 0,
+    BulkAccess,
+    InPlaceAccess,
+    MixedAccess,
+    AccessModeCount
+};
+
+static const char* const modeNames[AccessModeCount] = { "single", "bulk", "in place", "mixed" };
+
+static Ring ring;
+
+static void Produce(AccessMode mode, uint32_t items, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    uint32_t next = 0;
+    uint32_t batch[MAX_BATCH];
+
+    while (next < items) {
+        AccessMode m = (mode == MixedAccess) ? AccessMode(rng() % MixedAccess) : mode;
+        size_t want = (mode == MixedAccess) ? 1 + rng() % MAX_BATCH : MAX_BATCH;
+        if (want > items - next) want = items - next;
+        size_t done = 0;
+
+        if (m == SingleAccess) {
+            while (done < want && ring.Push(next + done)) done++;
+        } else if (m == BulkAccess) {
+            for (size_t i = 0; i < want; i++) batch[i] = next + i;
+            done = ring.PushBulk(batch, want);
+        } else {
+            Ring::Span span = ring.AcquireWrite();
+            done = span.count < want ? span.count : want;
+            for (size_t i = 0; i < done; i++) span.data[i] = next + i;
+            ring.CommitWrite(done);
+        }
+        next += done;
+        if (done == 0) std::this_thread::yield();
+    }
+}
+
+/* Returns the number of items that arrived out of sequence. */
+static uint32_t Consume(AccessMode mode, uint32_t items, uint32_t seed)
+{
+    std::mt19937 rng(seed ^ 0x5bd1e995u);
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    uint32_t batch[MAX_BATCH];
+
+    while (expected < items) {
+        AccessMode m = (mode == MixedAccess) ? AccessMode(rng() % MixedAccess) : mode;
+        size_t want = (mode == MixedAccess) ? 1 + rng() % MAX_BATCH : MAX_BATCH;
+        size_t done = 0;
+
+        if (m == SingleAccess) {
+            uint32_t item;
+            while (done < want && ring.Pop(item)) {
+                if (item != expected + done) errors++;
+                done++;
+            }
+        } else if (m == BulkAccess) {
+            done = ring.PopBulk(batch, want);
+            for (size_t i = 0; i < done; i++) {
+                if (batch[i] != expected + i) errors++;
+            }
+        } else {
+            Ring::Span span = ring.AcquireRead();
+            done = span.count < want ? span.count : want;
+            for (size_t i = 0; i < done; i++) {
+                if (span.data[i] != expected + i) errors++;
+            }
+            ring.ReleaseRead(done);
+        }
+        expected += done;
+        if (done == 0) std::this_thread::yield();
+    }
+    return errors;
+}
+
+static bool Run(AccessMode mode, uint32_t items, uint32_t seed)
+{
+    uint32_t errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer(Produce, mode, items, seed);
+    std::thread consumer([&]() { errors = Consume(mode, items, seed); });
+    producer.join();
+    consumer.join();
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    if (!ring.IsEmpty()) errors++;
+    printf("%-9s %u items, %.1f Mitems/s, %.2f ns/item, errors %u\n", modeNames[mode], items,
+           items / seconds / 1e6, seconds * 1e9 / items, errors);
+    return errors == 0;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t items = 20000000U;
+    uint32_t seed = 1U;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            items = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--items N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("ring of %d x %zu bytes, batches up to %d, %u hardware threads\n", RING_SIZE, sizeof(uint32_t),
+           MAX_BATCH, std::thread::hardware_concurrency());
+    bool ok = true;
+    for (int mode = 0; mode < AccessModeCount; mode++) {
+        ok = Run(AccessMode(mode), items, seed) && ok;
+    }
+    return ok ? 0 : 1;
+}
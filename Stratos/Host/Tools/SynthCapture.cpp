@@ -0,0 +1,340 @@
+/*
+ * SynthCapture.cpp
+ *
+ *  Created on: 18.10.2026
+ */
+
+/* Writes a synthetic rtl-sdr capture (unsigned 8 bit I/Q at 2 or 2.4 MS/s) holding
+ * Mode S frames with valid parity, so the decoder can be benchmarked and
+ * regressed without a dongle or a recorded capture. Traffic is a mix of
+ * DF17 identification, airborne position (real CPR encoding), velocity and
+ * DF11 all-call replies from a small fleet around the reference position.
+ * Frames land on random sample and sub-sample offsets, so some of them
+ * straddle USB buffer boundaries.
+ *
+ * usage: SynthCapture <out.iq> [--seconds S] [--rate FRAMES_PER_S]
+ *                     [--sampling 2000000|2400000]
+ *                     [--amplitude A] [--noise SIGMA] [--seed N]
+ *                     [--errors1 P] [--errors2 P] */
+
+#include "ADSBDecoder.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define SYNTH_REF_LAT 51.109402
+#define SYNTH_REF_LON 17.059798
+#define SYNTH_FLEET 24
+
+struct SynthAircraft
+{
+	uint32_t icao;
+	double lat;
+	double lon;
+	int altitude;
+	int ewVelocity;
+	int nsVelocity;
+	char callsign[9];
+	int nextOdd;
+};
+
+static uint32_t ModeSParity(const uint8_t* msg, int bits)
+{
+	/* Plain long division by the Mode S generator 0x1FFF409. */
+	uint32_t crc = 0;
+	for(int i = 0; i < bits - 24; i++)
+	{
+		uint32_t bit = (msg[i / 8] >> (7 - (i % 8))) & 1U;
+		uint32_t top = ((crc >> 23) & 1U) ^ bit;
+		crc = (crc << 1) & 0xFFFFFFU;
+		if(top)
+		{
+			crc ^= 0xFFF409U;
+		}
+	}
+	return crc;
+}
+
+static void SetParity(uint8_t* msg, int bits, uint32_t pi)
+{
+	int last = bits / 8;
+	msg[last - 3] = pi >> 16;
+	msg[last - 2] = pi >> 8;
+	msg[last - 1] = pi;
+}
+
+static int CprNL(double lat)
+{
+	if(fabs(lat) >= 87.0)
+	{
+		return 1;
+	}
+	const double nz = 15.0;
+	double a = 1.0 - cos(M_PI / (2.0 * nz));
+	double b = cos(M_PI / 180.0 * fabs(lat));
+	return int(floor(2.0 * M_PI / acos(1.0 - a / (b * b))));
+}
+
+static void CprEncode(double lat, double lon, int odd, int* yz, int* xz)
+{
+	double dlat = 360.0 / (60.0 - odd);
+	double y = floor(131072.0 * fmod(lat + 360.0, dlat) / dlat + 0.5);
+	double rlat = dlat * (y / 131072.0 + floor(lat / dlat));
+	int nl = CprNL(rlat) - odd;
+	double dlon = 360.0 / (nl > 0 ? nl : 1);
+	double x = floor(131072.0 * fmod(lon + 360.0, dlon) / dlon + 0.5);
+	*yz = int(y) & 0x1FFFF;
+	*xz = int(x) & 0x1FFFF;
+}
+
+static int AisChar(char c)
+{
+	if(c >= 'A' && c <= 'Z') return c - 'A' + 1;
+	if(c >= '0' && c <= '9') return c;
+	return 32;
+}
+
+static void SetIcao(uint8_t* msg, uint32_t icao)
+{
+	msg[1] = icao >> 16;
+	msg[2] = icao >> 8;
+	msg[3] = icao;
+}
+
+static int BuildFrame(SynthAircraft& ac, std::mt19937& rng, uint8_t* msg)
+{
+	memset(msg, 0, MODES_LONG_MSG_BYTES);
+	int kind = rng() % 10;
+
+	if(kind == 0)
+	{
+		/* DF11 all-call reply, II = 0 so PI is the plain parity. */
+		msg[0] = (11 << 3) | 5;
+		SetIcao(msg, ac.icao);
+		SetParity(msg, MODES_SHORT_MSG_BITS, ModeSParity(msg, MODES_SHORT_MSG_BITS));
+		return MODES_SHORT_MSG_BITS;
+	}
+
+	msg[0] = (17 << 3) | 5;
+	SetIcao(msg, ac.icao);
+
+	if(kind == 1)
+	{
+		int c[8];
+		for(int i = 0; i < 8; i++)
+		{
+			c[i] = AisChar(ac.callsign[i]);
+		}
+		msg[4] = (4 << 3) | 3;
+		msg[5] = (c[0] << 2) | (c[1] >> 4);
+		msg[6] = ((c[1] & 15) << 4) | (c[2] >> 2);
+		msg[7] = ((c[2] & 3) << 6) | c[3];
+		msg[8] = (c[4] << 2) | (c[5] >> 4);
+		msg[9] = ((c[5] & 15) << 4) | (c[6] >> 2);
+		msg[10] = ((c[6] & 3) << 6) | c[7];
+	}
+	else if(kind <= 3)
+	{
+		int ew = ac.ewVelocity < 0 ? -ac.ewVelocity : ac.ewVelocity;
+		int ns = ac.nsVelocity < 0 ? -ac.nsVelocity : ac.nsVelocity;
+		ew += 1;
+		ns += 1;
+		int vr = 1;
+		msg[4] = (19 << 3) | 1;
+		msg[5] = ((ac.ewVelocity < 0) << 2) | ((ew >> 8) & 3);
+		msg[6] = ew & 0xFF;
+		msg[7] = ((ac.nsVelocity < 0) << 7) | ((ns >> 3) & 0x7F);
+		msg[8] = ((ns & 7) << 5) | ((vr >> 6) & 7);
+		msg[9] = (vr & 0x3F) << 2;
+	}
+	else
+	{
+		int yz, xz;
+		int odd = ac.nextOdd;
+		ac.nextOdd ^= 1;
+		CprEncode(ac.lat, ac.lon, odd, &yz, &xz);
+		int n = (ac.altitude + 1000) / 25;
+		msg[4] = (11 << 3);
+		msg[5] = ((n >> 4) << 1) | 1;
+		msg[6] = ((n & 15) << 4) | (odd << 2) | ((yz >> 15) & 3);
+		msg[7] = (yz >> 7) & 0xFF;
+		msg[8] = ((yz & 0x7F) << 1) | ((xz >> 16) & 1);
+		msg[9] = (xz >> 8) & 0xFF;
+		msg[10] = xz & 0xFF;
+	}
+	SetParity(msg, MODES_LONG_MSG_BITS, ModeSParity(msg, MODES_LONG_MSG_BITS));
+	return MODES_LONG_MSG_BITS;
+}
+
+/* Adds one frame to the envelope, starting at a fractional sample offset.
+ * Each chip is 0.5 us (chip samples long); a sample collects the fraction of
+ * its duration during which the pulse is on. */
+static void Modulate(std::vector<float>& envelope, double start, double chip, const uint8_t* msg, int bits)
+{
+	std::vector<uint8_t> chips(16 + bits * 2, 0);
+	chips[0] = chips[2] = chips[7] = chips[9] = 1;
+	for(int i = 0; i < bits; i++)
+	{
+		int bit = (msg[i / 8] >> (7 - (i % 8))) & 1;
+		chips[16 + 2 * i] = bit;
+		chips[16 + 2 * i + 1] = !bit;
+	}
+
+	for(size_t c = 0; c < chips.size(); c++)
+	{
+		if(!chips[c])
+		{
+			continue;
+		}
+		double on = start + c * chip;
+		double off = on + chip;
+		if(size_t(off) + 1 >= envelope.size())
+		{
+			break;
+		}
+		for(size_t s = size_t(floor(on)); double(s) < off; s++)
+		{
+			double lo = on > double(s) ? on : double(s);
+			double hi = off < double(s + 1) ? off : double(s + 1);
+			envelope[s] += float(hi - lo);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* path = NULL;
+	double seconds = 2.0;
+	double rate = 2000.0;
+	double sampling = 2000000.0;
+	double amplitude = 40.0;
+	double noise = 4.0;
+	double errors1 = 0.0;
+	double errors2 = 0.0;
+	unsigned seed = 1U;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if(strcmp(arg, "--seconds") == 0 && val)        { seconds = atof(val); i++; }
+		else if(strcmp(arg, "--rate") == 0 && val)      { rate = atof(val); i++; }
+		else if(strcmp(arg, "--sampling") == 0 && val)  { sampling = atof(val); i++; }
+		else if(strcmp(arg, "--amplitude") == 0 && val) { amplitude = atof(val); i++; }
+		else if(strcmp(arg, "--noise") == 0 && val)     { noise = atof(val); i++; }
+		else if(strcmp(arg, "--errors1") == 0 && val)   { errors1 = atof(val); i++; }
+		else if(strcmp(arg, "--errors2") == 0 && val)   { errors2 = atof(val); i++; }
+		else if(strcmp(arg, "--seed") == 0 && val)      { seed = strtoul(val, NULL, 0); i++; }
+		else if(path == NULL && arg[0] != '-')          { path = arg; }
+		else
+		{
+			path = NULL;
+			break;
+		}
+	}
+	if(path == NULL || (sampling != 2000000.0 && sampling != 2400000.0))
+	{
+		fprintf(stderr, "usage: %s <out.iq> [--seconds S] [--rate FRAMES_PER_S] "
+				"[--sampling 2000000|2400000] [--amplitude A] [--noise SIGMA] [--seed N] [--errors1 P] [--errors2 P]\n", argv[0]);
+		return 2;
+	}
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	std::normal_distribution<float> gauss(0.0F, float(noise));
+
+	SynthAircraft fleet[SYNTH_FLEET];
+	for(int i = 0; i < SYNTH_FLEET; i++)
+	{
+		SynthAircraft& ac = fleet[i];
+		ac.icao = 0x400000U + (rng() & 0x3FFFFFU);
+		double range = 20.0 + 250.0 * uniform(rng);  /* km */
+		double bearing = 2.0 * M_PI * uniform(rng);
+		ac.lat = SYNTH_REF_LAT + range / 111.2 * cos(bearing);
+		ac.lon = SYNTH_REF_LON + range / (111.2 * cos(SYNTH_REF_LAT * M_PI / 180.0)) * sin(bearing);
+		ac.altitude = 1000 + 25 * int(rng() % 1500);
+		ac.ewVelocity = int(rng() % 900) - 450;
+		ac.nsVelocity = int(rng() % 900) - 450;
+		snprintf(ac.callsign, sizeof(ac.callsign), "SYN%04u ", unsigned(rng() % 10000));
+		ac.nextOdd = rng() & 1;
+	}
+
+	const double chip = sampling / 2000000.0;
+	const size_t samples = size_t(seconds * sampling);
+	const size_t bufferSamples = USB_IN_STREAM_SIZE / 2;
+	std::vector<float> envelope(samples + 512, 0.0F);
+	std::vector<float> phase(samples + 512, 0.0F);
+
+	/* Exponential inter-arrival times with a dead zone, so frames never
+	 * overlap each other. */
+	const double meanGap = sampling / rate;
+	const double minGap = (MODES_PREAMBLE_US * 2 + MODES_LONG_MSG_BITS * 2) * chip + 8;
+	std::exponential_distribution<double> gap(1.0 / (meanGap > minGap ? meanGap - minGap : 1.0));
+
+	size_t frames = 0U;
+	size_t seamFrames = 0U;
+	size_t corrupted = 0U;
+	double t = 50.0;
+	while(true)
+	{
+		t += minGap + gap(rng);
+		if(t + minGap >= samples)
+		{
+			break;
+		}
+		SynthAircraft& ac = fleet[rng() % SYNTH_FLEET];
+		uint8_t msg[MODES_LONG_MSG_BYTES];
+		int bits = BuildFrame(ac, rng, msg);
+
+		double p = uniform(rng);
+		int flips = (p < errors2) ? 2 : (p < errors2 + errors1) ? 1 : 0;
+		for(int f = 0; f < flips; f++)
+		{
+			int bit = 5 + rng() % (bits - 5);
+			msg[bit / 8] ^= 1 << (7 - (bit % 8));
+		}
+		corrupted += flips ? 1U : 0U;
+
+		size_t first = size_t(t);
+		size_t last = first + size_t((MODES_PREAMBLE_US * 2 + bits * 2) * chip);
+		if(first / bufferSamples != last / bufferSamples)
+		{
+			seamFrames++;
+		}
+		float carrier = float(2.0 * M_PI * uniform(rng));
+		for(size_t s = first; s <= last + 1; s++)
+		{
+			phase[s] = carrier;
+		}
+		Modulate(envelope, t, chip, msg, bits);
+		frames++;
+	}
+
+	FILE* out = fopen(path, "wb");
+	if(out == NULL)
+	{
+		fprintf(stderr, "cannot create %s\n", path);
+		return 1;
+	}
+	std::vector<uint8_t> iq(samples * 2);
+	for(size_t s = 0; s < samples; s++)
+	{
+		float a = float(amplitude) * envelope[s];
+		float i = 127.5F + a * cosf(phase[s]) + gauss(rng);
+		float q = 127.5F + a * sinf(phase[s]) + gauss(rng);
+		i = i < 0.0F ? 0.0F : (i > 255.0F ? 255.0F : i);
+		q = q < 0.0F ? 0.0F : (q > 255.0F ? 255.0F : q);
+		iq[2 * s] = uint8_t(lrintf(i));
+		iq[2 * s + 1] = uint8_t(lrintf(q));
+	}
+	fwrite(iq.data(), 1, iq.size(), out);
+	fclose(out);
+
+	fprintf(stderr, "%s: %zu samples, %zu frames (%zu across buffer seams, %zu with bit errors)\n",
+			path, samples, frames, seamFrames, corrupted);
+	return 0;
+}
@@ -65,20 +65,22 @@
 #include "FlightControl.h"
 #include "FlightControlControler.h"
 #include "timers.h"
+#include "CycleCounter.h"
+#include "libusb_port.h"
 
  BoardMenager boardMenager;
 
 
 SemaphoreHandle_t xSemaphore = NULL;
-QueueHandle_t messageQueue = NULL;
+MessageBus messageBus;
+SampleClock sampleClock;
 TimerHandle_t modelTimer = NULL;
-TimerHandle_t radarRefreshTimer = NULL;
 
 
 
 FlightCotrolView view;
 FlightControl model;
-FlightControlControler controler(model,view);
+FlightControlControler controler(model,view,sampleClock);
 
 static uint32_t ticks = 0;
 
@@ -94,7 +96,7 @@ void USBMonitorTask(void*)
 		{
 			vTaskSuspendAll();
 			usbDriverHandle.InitHost();
-			rtlSdrHandle.OpenDevice(0,1090000000,2000000);
+			rtlSdrHandle.OpenDevice(0,ADS_B_FREQUENCY,ADS_B_SAMPLING);
 			//controler.NotifyConnected();
 			xTaskResumeAll();
 		}
@@ -108,14 +110,20 @@ void USBMonitorTask(void*)
 void RTLSDRDataAquisitionTask(void*)
 {
 	RTLSDR& rtlsdrHandle = boardMenager.GetRTLSDR();
-	ADS_BDecoder decoder(messageQueue);
+	ADS_BDecoder decoder(messageBus, sampleClock);
 
 	while(1)
 	{
 		if( xSemaphoreTake( xSemaphore, 100) == pdTRUE )
 		{
-			decoder.ProcessRawSamples(rtlsdrHandle.GetRawSamplesFromBuffer());
-			rtlsdrHandle.GetNewRawSamples();
+			/* The semaphore only says something arrived, the dongle may
+			 * have filled several buffers meanwhile. */
+			const RawSampleBuffer* buffer;
+			while((buffer = rtlsdrHandle.GetRawSamplesFromBuffer()) != NULL)
+			{
+				decoder.ProcessRawSamples(buffer->samples.data(), buffer->time);
+				rtlsdrHandle.NotifyRawSampleProcessed();
+			}
 		}
 	}
 }
@@ -123,19 +131,31 @@ void RTLSDRDataAquisitionTask(void*)
 
 void FlightControlerTask(void *)
 {
-	ADS_BMessage msg;
+	ADS_BMessage batch[MESSAGE_BUS_BATCH];
 	while(1)
 	{
 		if(ticks > 0)
 		{
-			uint32_t ticksTmp = ticks;
-			controler.UpdateTicksCount(ticksTmp);
-			ticks -= ticksTmp;
+			/* Only that a second went by matters, not how many. */
+			ticks = 0;
+			controler.ExpireRecords();
 			controler.UpdateView();
 		}
-		if(xQueueReceive(messageQueue,&msg,10) == pdTRUE)
+		if(messageBus.Wait(10) == true)
 		{
-			controler.PassNewMessage(msg);
+			/* At most one bus worth per wake, so ticks and the view are
+			 * still serviced under heavy traffic. */
+			size_t drained = 0;
+			size_t count;
+			while(drained < MESSAGE_BUS_CAPACITY &&
+				  (count = messageBus.Drain(batch,MESSAGE_BUS_BATCH)) > 0)
+			{
+				for(size_t i = 0; i < count; i++)
+				{
+					controler.PassNewMessage(batch[i]);
+				}
+				drained += count;
+			}
 		}
 	}
 }
@@ -147,6 +167,7 @@ void GUITask(void*)
 
 	while(1)
 	{
+		view.Refresh();
 		GUI_Exec();
 
 		vTaskDelay(100);
@@ -161,14 +182,9 @@ void vTimerCallback(TimerHandle_t xTimer)
 	ticks++;
 }
 
-void vTimer2Callback(TimerHandle_t xTimer)
-{
-	view.UpdateRadar();
-}
-
 int main(void)
 {
-
+  CycleCounterInit();
 
   MX_I2C4_Init();
   MX_SDMMC1_SD_Init();
@@ -189,11 +205,8 @@ int main(void)
   xTaskCreate(RTLSDRDataAquisitionTask,"task3",2048,NULL,osPriorityHigh  ,NULL);
   xTaskCreate(FlightControlerTask,"dupa",2048,NULL,osPriorityNormal  ,NULL);
   xSemaphore = xSemaphoreCreateBinary();
-  messageQueue = xQueueCreate(5,sizeof(ADS_BMessage));
   modelTimer= xTimerCreate("Timer",1000U,pdTRUE,NULL, vTimerCallback);
   xTimerStart(modelTimer,1000);
-  radarRefreshTimer= xTimerCreate("Timer2",1000U,pdTRUE,NULL, vTimer2Callback);
-  xTimerStart(radarRefreshTimer,1000);
   /* Start scheduler */
 
 
@@ -270,12 +283,16 @@ extern "C" void HAL_HCD_HC_NotifyURBChange_Callback(HCD_HandleTypeDef *hhcd, uin
 #endif
 
   UNUSED(hhcd);
-  UNUSED(chnum);
+
+  /* Streams started with rtlsdr_read_async are handled by the libusb port. */
+  if(libusb_port_urb_callback(chnum, urb_state) != 0) { return; }
 
   if(boardMenager.GetRTLSDR().IsDeviceReady() == false) { return; }
 
   if (urb_state == URB_DONE)
   {
+		/* Resubmit before waking the decoder. */
+		boardMenager.GetRTLSDR().NotifyNewRawSampleRecived();
 		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 		xSemaphoreGiveFromISR( xSemaphore , &xHigherPriorityTaskWoken );
 		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
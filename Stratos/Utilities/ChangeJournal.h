@@ -0,0 +1,131 @@
+/*
+ * ChangeJournal.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef CHANGEJOURNAL_H_
+#define CHANGEJOURNAL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/* Bounded log of T entries with a read cursor for each of up to
+ * TConsumers consumers, without any heap. Writer and consumers run in the
+ * same task.
+ *
+ * Entries go into a ring of TSize (a power of two) and are numbered by a
+ * free running counter. Append() never waits for a consumer: once the ring
+ * is full it overwrites the oldest entry. A consumer that was more than
+ * TSize entries behind has lost some, Read() then returns nothing and
+ * NeedsResync() is true until the consumer rebuilt its state from the
+ * source and called Resync(). Appending is O(1), reading costs one copy per
+ * entry read, whatever the number of consumers. */
+template<class T, size_t TSize, size_t TConsumers>
+class ChangeJournal
+{
+public:
+    static_assert(TSize >= 2 && (TSize & (TSize - 1)) == 0, "ChangeJournal size must be a power of two");
+    static_assert(TConsumers > 0 && TConsumers < 0xFF, "ChangeJournal consumers must fit a byte");
+
+    typedef uint8_t Consumer;
+    static const Consumer InvalidConsumer = 0xFF;
+
+    ChangeJournal();
+
+    void Append(const T& entry);
+
+    /* A new consumer, InvalidConsumer if all are taken. It starts at the
+     * end of the journal, after building its state from the source. */
+    Consumer Subscribe();
+    void Unsubscribe(Consumer consumer);
+
+    /* Copies up to count of the consumer's next entries to entries and
+     * moves its cursor past them, 0 when it is up to date or needs a
+     * resync. */
+    size_t Read(Consumer consumer, T* entries, size_t count);
+    /* Entries were overwritten before the consumer read them. */
+    bool NeedsResync(Consumer consumer) const { return head - cursors[consumer] > TSize; }
+    /* Moves the consumer to the end of the journal, once it rebuilt its
+     * state from the source. */
+    void Resync(Consumer consumer) { cursors[consumer] = head; }
+    /* Entries the consumer has not read yet, more than TSize when it needs
+     * a resync. */
+    uint32_t Pending(Consumer consumer) const { return head - cursors[consumer]; }
+
+    /* Entries appended so far. */
+    uint32_t GetHead() const { return head; }
+    static constexpr size_t Capacity() { return TSize; }
+
+private:
+    T entries[TSize];
+    uint32_t head;
+    uint32_t cursors[TConsumers];
+    bool subscribed[TConsumers];
+};
+
+
+
+
+
+template<class T, size_t TSize, size_t TConsumers>
+ChangeJournal<T,TSize,TConsumers>::ChangeJournal()
+{
+    head = 0U;
+    for(size_t i = 0; i < TConsumers; i++)
+    {
+        cursors[i] = 0U;
+        subscribed[i] = false;
+    }
+}
+
+template<class T, size_t TSize, size_t TConsumers>
+void ChangeJournal<T,TSize,TConsumers>::Append(const T& entry)
+{
+    entries[head & (TSize - 1)] = entry;
+    head++;
+}
+
+template<class T, size_t TSize, size_t TConsumers>
+typename ChangeJournal<T,TSize,TConsumers>::Consumer ChangeJournal<T,TSize,TConsumers>::Subscribe()
+{
+    for(size_t i = 0; i < TConsumers; i++)
+    {
+        if(!subscribed[i])
+        {
+            subscribed[i] = true;
+            cursors[i] = head;
+            return Consumer(i);
+        }
+    }
+    return InvalidConsumer;
+}
+
+template<class T, size_t TSize, size_t TConsumers>
+void ChangeJournal<T,TSize,TConsumers>::Unsubscribe(Consumer consumer)
+{
+    subscribed[consumer] = false;
+}
+
+template<class T, size_t TSize, size_t TConsumers>
+size_t ChangeJournal<T,TSize,TConsumers>::Read(Consumer consumer, T* out, size_t count)
+{
+    const uint32_t cursor = cursors[consumer];
+    const uint32_t pending = head - cursor;
+    if(pending > TSize)
+    {
+        return 0;
+    }
+    if(count > pending)
+    {
+        count = pending;
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        out[i] = entries[(cursor + i) & (TSize - 1)];
+    }
+    cursors[consumer] = cursor + count;
+    return count;
+}
+
+#endif /* CHANGEJOURNAL_H_ */
@@ -0,0 +1,58 @@
+/*
+ * CycleCounter.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef CYCLECOUNTER_H_
+#define CYCLECOUNTER_H_
+
+#include <cstdint>
+
+/* Free running 32 bit tick source used for cheap in-field profiling.
+ * On the target it is the Cortex-M7 DWT cycle counter, on the host build
+ * the shim's time in nanoseconds (HostTimeNs). Differences of two readings
+ * are valid as long as the interval is shorter than one wrap of the
+ * counter. */
+#if defined(STM32F767xx)
+
+#include "stm32f7xx.h"
+
+inline void CycleCounterInit()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline uint32_t CycleCounterNow()
+{
+	return DWT->CYCCNT;
+}
+
+inline uint32_t CycleCounterFrequency()
+{
+	return SystemCoreClock;
+}
+
+#else
+
+#include "cmsis_os.h"
+
+inline void CycleCounterInit()
+{
+}
+
+inline uint32_t CycleCounterNow()
+{
+	return static_cast<uint32_t>(HostTimeNs());
+}
+
+inline uint32_t CycleCounterFrequency()
+{
+	return 1000000000U;
+}
+
+#endif
+
+#endif /* CYCLECOUNTER_H_ */
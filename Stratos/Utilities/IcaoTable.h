@@ -0,0 +1,243 @@
+/*
+ * IcaoTable.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef ICAOTABLE_H_
+#define ICAOTABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/* Fixed capacity map from a 24 bit ICAO address to T, without any heap.
+ *
+ * The values live in a slot array and never move, so the handle (slot
+ * number) of an entry, and a pointer to its value, stay valid until the
+ * entry is erased. Lookup goes through a separate open addressing index of
+ * at least twice TCapacity buckets (a power of two), holding the key and
+ * the slot, with linear probing from a Fibonacci hash of the address.
+ * Erase shifts the following entries of the probe run back into the hole
+ * instead of leaving a tombstone, so probe runs never degrade under
+ * constant insert/expire churn.
+ *
+ * Iteration visits the used slots in slot order; erasing the current entry
+ * while iterating is allowed. */
+template<class T, size_t TCapacity>
+class IcaoTable
+{
+public:
+    static_assert(TCapacity > 0 && TCapacity < 0xFFFF, "IcaoTable capacity must fit a 16 bit handle");
+
+    typedef uint16_t Handle;
+    static const Handle InvalidHandle = 0xFFFF;
+
+    template<class TTable, class TValue>
+    class IteratorBase
+    {
+    public:
+        IteratorBase(TTable* table, size_t slot) : table(table), slot(slot) { Skip(); }
+        TValue& operator*() const { return table->values[slot]; }
+        TValue* operator->() const { return &table->values[slot]; }
+        IteratorBase& operator++() { slot++; Skip(); return *this; }
+        IteratorBase operator++(int) { IteratorBase it = *this; ++(*this); return it; }
+        bool operator==(const IteratorBase& other) const { return slot == other.slot; }
+        bool operator!=(const IteratorBase& other) const { return slot != other.slot; }
+        Handle GetHandle() const { return Handle(slot); }
+    private:
+        void Skip() { while(slot < TCapacity && table->keys[slot] == EmptyKey) slot++; }
+        TTable* table;
+        size_t slot;
+    };
+    typedef IteratorBase<IcaoTable, T> iterator;
+    typedef IteratorBase<const IcaoTable, const T> const_iterator;
+
+    IcaoTable();
+
+    /* Handle of the entry for icao, InvalidHandle if there is none. */
+    Handle Find(uint32_t icao) const;
+    /* Adds an entry, InvalidHandle when the table is full or icao is
+     * already in it. */
+    Handle Insert(uint32_t icao, const T& value);
+    bool Erase(uint32_t icao);
+    void EraseHandle(Handle handle);
+    void Clear();
+
+    T& Get(Handle handle) { return values[handle]; }
+    const T& Get(Handle handle) const { return values[handle]; }
+    uint32_t GetKey(Handle handle) const { return keys[handle]; }
+
+    size_t Size() const { return count; }
+    bool IsFull() const { return count == TCapacity; }
+    static constexpr size_t Capacity() { return TCapacity; }
+    static constexpr size_t IndexSize() { return indexSize; }
+    /* Longest probe run, from a bucket to the entry it holds, in buckets. */
+    size_t MaxProbeLength() const;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, TCapacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, TCapacity); }
+
+private:
+    static constexpr uint32_t EmptyKey = 0xFFFFFFFFU;
+
+    static constexpr size_t IndexBits(size_t n)
+    {
+        size_t bits = 1;
+        while((size_t(1) << bits) < 2 * n)
+        {
+            bits++;
+        }
+        return bits;
+    }
+    static constexpr size_t indexBits = IndexBits(TCapacity);
+    static constexpr size_t indexSize = size_t(1) << indexBits;
+    static constexpr size_t indexMask = indexSize - 1;
+
+    struct Bucket
+    {
+        uint32_t key;
+        Handle slot;
+    };
+
+    static size_t Home(uint32_t icao)
+    {
+        return size_t((icao * 0x9E3779B1U) >> (32 - indexBits));
+    }
+    /* Bucket holding icao, or the empty bucket ending its probe run. */
+    size_t Probe(uint32_t icao) const;
+    void RemoveFromIndex(size_t bucket);
+
+    Bucket index[indexSize];
+    uint32_t keys[TCapacity];       /* Key of every slot, EmptyKey when free. */
+    Handle freeSlots[TCapacity];
+    size_t freeCount;
+    size_t count;
+    T values[TCapacity];
+};
+
+
+
+
+
+template<class T, size_t TCapacity>
+IcaoTable<T,TCapacity>::IcaoTable()
+{
+    Clear();
+}
+
+template<class T, size_t TCapacity>
+void IcaoTable<T,TCapacity>::Clear()
+{
+    for(size_t i = 0; i < indexSize; i++)
+    {
+        index[i].key = EmptyKey;
+    }
+    /* Free slots are handed out lowest first. */
+    for(size_t i = 0; i < TCapacity; i++)
+    {
+        keys[i] = EmptyKey;
+        freeSlots[i] = Handle(TCapacity - 1 - i);
+    }
+    freeCount = TCapacity;
+    count = 0;
+}
+
+template<class T, size_t TCapacity>
+size_t IcaoTable<T,TCapacity>::Probe(uint32_t icao) const
+{
+    size_t bucket = Home(icao);
+    while(index[bucket].key != EmptyKey && index[bucket].key != icao)
+    {
+        bucket = (bucket + 1) & indexMask;
+    }
+    return bucket;
+}
+
+template<class T, size_t TCapacity>
+typename IcaoTable<T,TCapacity>::Handle IcaoTable<T,TCapacity>::Find(uint32_t icao) const
+{
+    const size_t bucket = Probe(icao);
+    return (index[bucket].key == EmptyKey) ? InvalidHandle : index[bucket].slot;
+}
+
+template<class T, size_t TCapacity>
+typename IcaoTable<T,TCapacity>::Handle IcaoTable<T,TCapacity>::Insert(uint32_t icao, const T& value)
+{
+    const size_t bucket = Probe(icao);
+    if(index[bucket].key != EmptyKey || freeCount == 0)
+    {
+        return InvalidHandle;
+    }
+    const Handle slot = freeSlots[--freeCount];
+    index[bucket].key = icao;
+    index[bucket].slot = slot;
+    keys[slot] = icao;
+    values[slot] = value;
+    count++;
+    return slot;
+}
+
+template<class T, size_t TCapacity>
+bool IcaoTable<T,TCapacity>::Erase(uint32_t icao)
+{
+    const size_t bucket = Probe(icao);
+    if(index[bucket].key == EmptyKey)
+    {
+        return false;
+    }
+    const Handle slot = index[bucket].slot;
+    RemoveFromIndex(bucket);
+    keys[slot] = EmptyKey;
+    freeSlots[freeCount++] = slot;
+    count--;
+    return true;
+}
+
+template<class T, size_t TCapacity>
+void IcaoTable<T,TCapacity>::EraseHandle(Handle handle)
+{
+    Erase(keys[handle]);
+}
+
+/* Backward shift: every following entry of the run that may live in the
+ * hole (its home is not between the hole and itself) moves into it, and
+ * its old bucket becomes the hole. */
+template<class T, size_t TCapacity>
+void IcaoTable<T,TCapacity>::RemoveFromIndex(size_t hole)
+{
+    size_t bucket = hole;
+    while(true)
+    {
+        bucket = (bucket + 1) & indexMask;
+        if(index[bucket].key == EmptyKey)
+        {
+            break;
+        }
+        const size_t home = Home(index[bucket].key);
+        if(((bucket - home) & indexMask) >= ((bucket - hole) & indexMask))
+        {
+            index[hole] = index[bucket];
+            hole = bucket;
+        }
+    }
+    index[hole].key = EmptyKey;
+}
+
+template<class T, size_t TCapacity>
+size_t IcaoTable<T,TCapacity>::MaxProbeLength() const
+{
+    size_t longest = 0;
+    for(size_t bucket = 0; bucket < indexSize; bucket++)
+    {
+        if(index[bucket].key != EmptyKey)
+        {
+            const size_t length = (bucket - Home(index[bucket].key)) & indexMask;
+            longest = (length > longest) ? length : longest;
+        }
+    }
+    return longest;
+}
+
+#endif /* ICAOTABLE_H_ */
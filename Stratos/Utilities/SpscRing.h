@@ -0,0 +1,228 @@
+/*
+ * SpscRing.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef SPSCRING_H_
+#define SPSCRING_H_
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Data cache line: 32 bytes on the Cortex-M7, 64 on the host. */
+#if defined(STM32F767xx)
+#define SPSC_CACHE_LINE 32
+#else
+#define SPSC_CACHE_LINE 64
+#endif
+
+/* Lock free ring for exactly one producer and one consumer, either of which
+ * may run in an interrupt handler (e.g. the URB completion callback) while
+ * the other is a task. No critical section is ever taken.
+ *
+ * head and tail are free running counters, the slot is counter % TSize, so
+ * all TSize slots are usable and TSize must be a power of two. Each side
+ * only writes its own counter, with release ordering after the slots are
+ * written or read, and keeps a cached copy of the other one so the shared
+ * cache line is only reloaded when the cached view does not have enough
+ * room (or items). The two counters and the slots live on separate cache
+ * lines.
+ *
+ * Besides single and bulk copies, both sides can work in place: Acquire
+ * returns the largest contiguous span of free (or filled) slots, Commit /
+ * Release publishes the part of it that was used. The slot array is cache
+ * line aligned, so with a suitable T spans can be DMA/USB targets. */
+template<class T, size_t TSize>
+class SpscRing
+{
+public:
+    static_assert(TSize >= 2 && (TSize & (TSize - 1)) == 0, "SpscRing size must be a power of two");
+
+    struct Span
+    {
+        T* data;
+        size_t count;
+    };
+
+    SpscRing();
+
+    /* Producer side. */
+    bool Push(const T& item);
+    size_t PushBulk(const T* items, size_t count);
+    Span AcquireWrite();
+    void CommitWrite(size_t count);
+
+    /* Consumer side. */
+    bool Pop(T& item);
+    size_t PopBulk(T* items, size_t count);
+    Span AcquireRead();
+    void ReleaseRead(size_t count);
+
+    /* Exact from either side for its own view, a snapshot otherwise. */
+    size_t Size() const;
+    bool IsEmpty() const { return Size() == 0; }
+    bool IsFull() const { return Size() == TSize; }
+    static constexpr size_t Capacity() { return TSize; }
+
+private:
+    /* Slots available to each side, the other side's counter is only
+     * reloaded when the cached copy shows fewer than wanted. */
+    size_t FreeForProducer(uint32_t h, size_t wanted);
+    size_t FilledForConsumer(uint32_t t, size_t wanted);
+
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head;   /* Written by the producer. */
+    uint32_t cachedTail;
+    alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> tail;   /* Written by the consumer. */
+    uint32_t cachedHead;
+    alignas(SPSC_CACHE_LINE) std::array<T,TSize> buffer;
+};
+
+
+
+
+
+template<class T, size_t TSize>
+SpscRing<T,TSize>::SpscRing()
+{
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cachedTail = 0;
+    cachedHead = 0;
+}
+
+template<class T, size_t TSize>
+size_t SpscRing<T,TSize>::FreeForProducer(uint32_t h, size_t wanted)
+{
+    size_t free = TSize - (h - cachedTail);
+    if(free < wanted)
+    {
+        cachedTail = tail.load(std::memory_order_acquire);
+        free = TSize - (h - cachedTail);
+    }
+    return free;
+}
+
+template<class T, size_t TSize>
+size_t SpscRing<T,TSize>::FilledForConsumer(uint32_t t, size_t wanted)
+{
+    size_t filled = cachedHead - t;
+    if(filled < wanted)
+    {
+        cachedHead = head.load(std::memory_order_acquire);
+        filled = cachedHead - t;
+    }
+    return filled;
+}
+
+template<class T, size_t TSize>
+bool SpscRing<T,TSize>::Push(const T& item)
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if(FreeForProducer(h, 1) == 0)
+    {
+        return false;
+    }
+    buffer[h & (TSize - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T, size_t TSize>
+size_t SpscRing<T,TSize>::PushBulk(const T* items, size_t count)
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    size_t free = FreeForProducer(h, count);
+    if(count > free)
+    {
+        count = free;
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        buffer[(h + i) & (TSize - 1)] = items[i];
+    }
+    head.store(h + count, std::memory_order_release);
+    return count;
+}
+
+template<class T, size_t TSize>
+typename SpscRing<T,TSize>::Span SpscRing<T,TSize>::AcquireWrite()
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    size_t index = h & (TSize - 1);
+    size_t free = FreeForProducer(h, TSize - index);
+    if(free > TSize - index)
+    {
+        free = TSize - index;
+    }
+    Span span = { &buffer[index], free };
+    return span;
+}
+
+template<class T, size_t TSize>
+void SpscRing<T,TSize>::CommitWrite(size_t count)
+{
+    head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+template<class T, size_t TSize>
+bool SpscRing<T,TSize>::Pop(T& item)
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if(FilledForConsumer(t, 1) == 0)
+    {
+        return false;
+    }
+    item = buffer[t & (TSize - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T, size_t TSize>
+size_t SpscRing<T,TSize>::PopBulk(T* items, size_t count)
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    size_t filled = FilledForConsumer(t, count);
+    if(count > filled)
+    {
+        count = filled;
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        items[i] = buffer[(t + i) & (TSize - 1)];
+    }
+    tail.store(t + count, std::memory_order_release);
+    return count;
+}
+
+template<class T, size_t TSize>
+typename SpscRing<T,TSize>::Span SpscRing<T,TSize>::AcquireRead()
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    size_t index = t & (TSize - 1);
+    size_t filled = FilledForConsumer(t, TSize - index);
+    if(filled > TSize - index)
+    {
+        filled = TSize - index;
+    }
+    Span span = { &buffer[index], filled };
+    return span;
+}
+
+template<class T, size_t TSize>
+void SpscRing<T,TSize>::ReleaseRead(size_t count)
+{
+    tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+template<class T, size_t TSize>
+size_t SpscRing<T,TSize>::Size() const
+{
+    uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t h = head.load(std::memory_order_acquire);
+    return h - t;
+}
+
+#endif /* SPSCRING_H_ */
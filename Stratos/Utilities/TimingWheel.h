@@ -0,0 +1,121 @@
+/*
+ * TimingWheel.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef TIMINGWHEEL_H_
+#define TIMINGWHEEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/* Hashed timing wheel of handles 0 to TCapacity - 1, without any heap.
+ *
+ * Time is in ms and may wrap around, the wheel turns TSlots buckets of
+ * TSlotMs each. Scheduling puts a handle into the bucket of its deadline,
+ * or of the wheel's horizon when the deadline lies beyond it, and Advance()
+ * hands out the handles of every bucket it reaches. A handle comes back
+ * from the first Advance() at or after its deadline, at most a bucket
+ * late, or early when its deadline lay beyond the horizon, so the owner
+ * checks the real deadline and schedules the handle again if it is not
+ * due yet.
+ *
+ * A handle is in at most one bucket: it must not be scheduled again until
+ * Advance() has handed it out. Each bucket is a singly linked list through
+ * next[], so Schedule() is O(1) and Advance() costs one step per bucket
+ * passed plus one per handle handed out. */
+template<size_t TCapacity, size_t TSlots, uint32_t TSlotMs>
+class TimingWheel
+{
+public:
+    static_assert(TCapacity < 0xFFFF, "TimingWheel capacity must fit a 16 bit handle");
+    static_assert(TSlots > 1 && (TSlots & (TSlots - 1)) == 0, "TimingWheel slots must be a power of two");
+
+    typedef uint16_t Handle;
+
+    TimingWheel() { Clear(0U); }
+
+    /* Empties the wheel and sets its time. */
+    void Clear(uint32_t timeMs);
+    void Schedule(Handle handle, uint32_t deadlineMs);
+    /* Turns the wheel up to timeMs and calls expire(handle) for every
+     * handle of the buckets passed; expire may schedule the handle again. */
+    template<class TExpire>
+    void Advance(uint32_t timeMs, TExpire expire);
+
+    static constexpr uint32_t HorizonMs() { return (TSlots - 1) * TSlotMs; }
+
+private:
+    static const Handle EndOfList = 0xFFFF;
+
+    Handle heads[TSlots];
+    Handle next[TCapacity];
+    uint32_t cursor;            /* Next bucket to hand out, counting up. */
+    uint32_t cursorMs;          /* and the time it starts at. */
+};
+
+
+
+
+
+template<size_t TCapacity, size_t TSlots, uint32_t TSlotMs>
+void TimingWheel<TCapacity,TSlots,TSlotMs>::Clear(uint32_t timeMs)
+{
+    for(size_t i = 0; i < TSlots; i++)
+    {
+        heads[i] = EndOfList;
+    }
+    cursor = 0U;
+    cursorMs = timeMs - timeMs % TSlotMs;
+}
+
+template<size_t TCapacity, size_t TSlots, uint32_t TSlotMs>
+void TimingWheel<TCapacity,TSlots,TSlotMs>::Schedule(Handle handle, uint32_t deadlineMs)
+{
+    /* Buckets ahead of the cursor, the first one starting at or after the
+     * deadline, 0 for anything already due. */
+    const int32_t untilMs = int32_t(deadlineMs - cursorMs);
+    uint32_t ahead = (untilMs < 0) ? 0U : (uint32_t(untilMs) + TSlotMs - 1U) / TSlotMs;
+    if(ahead > TSlots - 1)
+    {
+        ahead = TSlots - 1;
+    }
+    const size_t bucket = (cursor + ahead) & (TSlots - 1);
+    next[handle] = heads[bucket];
+    heads[bucket] = handle;
+}
+
+template<size_t TCapacity, size_t TSlots, uint32_t TSlotMs>
+template<class TExpire>
+void TimingWheel<TCapacity,TSlots,TSlotMs>::Advance(uint32_t timeMs, TExpire expire)
+{
+    const int32_t passedMs = int32_t(timeMs - cursorMs);
+    if(passedMs < 0)
+    {
+        return;
+    }
+    uint32_t buckets = uint32_t(passedMs) / TSlotMs + 1U;
+    /* After a long pause every bucket comes up once, early. */
+    if(buckets > TSlots)
+    {
+        cursorMs += (buckets - TSlots) * TSlotMs;
+        buckets = TSlots;
+    }
+    while(buckets-- > 0U)
+    {
+        const size_t bucket = cursor & (TSlots - 1);
+        Handle handle = heads[bucket];
+        heads[bucket] = EndOfList;
+        cursor++;
+        cursorMs += TSlotMs;
+        while(handle != EndOfList)
+        {
+            const Handle following = next[handle];
+            expire(handle);
+            handle = following;
+        }
+    }
+}
+
+#endif /* TIMINGWHEEL_H_ */
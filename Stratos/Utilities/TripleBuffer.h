@@ -0,0 +1,84 @@
+/*
+ * TripleBuffer.h
+ *
+ *  Created on: 18.10.2026
+ */
+
+#ifndef TRIPLEBUFFER_H_
+#define TRIPLEBUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+
+/* Latest value handoff from exactly one writer to exactly one reader,
+ * without locks and without copying on either side.
+ *
+ * Of the three buffers the writer owns one (back), the reader owns one
+ * (front) and the third (middle) holds the last published value. Publish()
+ * swaps back with middle and marks middle fresh, Acquire() swaps a fresh
+ * middle with front. Each swap is a single atomic exchange of the packed
+ * middle index and fresh bit, so neither side ever waits and each side's
+ * buffer stays untouched by the other until it swaps it away. The reader
+ * sees whole values only, skips the ones published while it was busy, and
+ * keeps reading the same front until it acquires again.
+ *
+ * The buffers start value initialised, Front() is that until the first
+ * Acquire() that returns true. */
+template<class T>
+class TripleBuffer
+{
+public:
+    TripleBuffer();
+
+    /* Writer side: fill Back(), then Publish() hands it over. Back() is
+     * another buffer afterwards, holding an older value. */
+    T& Back() { return buffers[back]; }
+    void Publish();
+
+    /* Reader side: moves to the latest published value, false if nothing
+     * was published since the last call. */
+    bool Acquire();
+    const T& Front() const { return buffers[front]; }
+
+private:
+    static const uint32_t IndexMask = 0x3U;
+    static const uint32_t FreshBit = 0x4U;
+
+    T buffers[3];
+    uint32_t back;                  /* Writer only. */
+    uint32_t front;                 /* Reader only. */
+    std::atomic<uint32_t> middle;   /* Index | FreshBit. */
+};
+
+
+
+
+
+template<class T>
+TripleBuffer<T>::TripleBuffer() : buffers(), back(0U), front(1U)
+{
+    middle.store(2U, std::memory_order_relaxed);
+}
+
+/* Release makes the writes to back visible with it, acquire makes sure the
+ * reader is done with the buffer that comes back. */
+template<class T>
+void TripleBuffer<T>::Publish()
+{
+    back = middle.exchange(back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+}
+
+template<class T>
+bool TripleBuffer<T>::Acquire()
+{
+    /* Only the reader clears the fresh bit, so it stays set until the
+     * exchange even if the writer publishes again in between. */
+    if((middle.load(std::memory_order_relaxed) & FreshBit) == 0U)
+    {
+        return false;
+    }
+    front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+    return true;
+}
+
+#endif /* TRIPLEBUFFER_H_ */
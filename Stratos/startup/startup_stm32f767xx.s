@@ -93,6 +93,20 @@ LoopCopyDataInit:
   adds  r2, r0, r1
   cmp  r2, r3
   bcc  CopyDataInit
+
+/* Copy the DTCM RAM initializers (e.g. magnitude tables) from flash */
+  ldr  r0, =_sdtcmram
+  ldr  r1, =_edtcmram
+  ldr  r2, =_sidtcmram
+  b  LoopCopyDtcmInit
+
+CopyDtcmInit:
+  ldr  r3, [r2], #4
+  str  r3, [r0], #4
+
+LoopCopyDtcmInit:
+  cmp  r0, r1
+  bcc  CopyDtcmInit
   ldr  r2, =_sbss
   b  LoopFillZerobss
 /* Zero fill the bss segment. */  